@@ -1,4 +1,4 @@
-QT += qml quick gui widgets
+QT += qml quick gui widgets concurrent network
 CONFIG += c++11
 
 # The following define makes your compiler emit warnings if you use
@@ -12,18 +12,14 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+include(core/core.pri)
+
 SOURCES += \
         main.cpp \
-    crypto/AES256.cpp \
-    crypto/AESCommon.cpp \
-    crypto/BlockCipher.cpp \
-    crypto/CBC.cpp \
-    crypto/Cipher.cpp \
-    crypto/Crypto.cpp \
-    crypto/Hash.cpp \
-    crypto/pbkdf2.cpp \
-    crypto/SHA1.cpp \
-    crypto/SHA256.cpp \
+    src/CControlClient.cpp \
+    src/CControlServer.cpp \
+    src/CHeadless.cpp \
+    src/CModelBenchmark.cpp \
     src/CTaskModel.cpp \
     src/CTrayManager.cpp
 
@@ -65,6 +61,7 @@ DISTFILES += \
     src/AreYouSure.qml \
     src/EditContextMenu.qml \
     src/EditContextMenuReport.qml \
+    src/ImportCsvDialog.qml \
     src/LoadFileDialog.qml \
     src/Notification.qml \
     src/OptionsMenu.qml \
@@ -77,19 +74,10 @@ DISTFILES += \
     src/SortMenu.qml
 
 HEADERS += \
-    crypto/utility/EndianUtil.h \
-    crypto/utility/LimbUtil.h \
-    crypto/utility/ProgMemUtil.h \
-    crypto/utility/RotateUtil.h \
-    crypto/AES.h \
-    crypto/BlockCipher.h \
-    crypto/CBC.h \
-    crypto/Cipher.h \
-    crypto/Crypto.h \
-    crypto/Hash.h \
-    crypto/pbkdf2.h \
-    crypto/SHA1.h \
-    crypto/SHA256.h \
+    src/CControlClient.h \
+    src/CControlServer.h \
+    src/CHeadless.h \
+    src/CModelBenchmark.h \
     src/CTaskModel.h \
     src/CTrayManager.h
 
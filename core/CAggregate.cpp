@@ -0,0 +1,234 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include "CAggregate.h"
+
+#if defined(AGGREGATE_X86)
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SSE2_TARGET
+#define AVX2_TARGET
+#else
+#define SSE2_TARGET __attribute__((target("sse2")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+
+// The kernels: add up days first .. last of every row into perRow & OR them into mask (one entry per day)
+
+static void sum_scalar(const quint32 *matrix, int rows, int first, int last, quint32 *perRow, quint32 *mask)
+{
+    int r, d;
+    quint32 sum;
+
+    for (r=0; r<rows; r++) {
+        const quint32 *row = matrix + (size_t) r * AGGREGATE_DAYS;
+        sum = 0;
+        for (d=first; d<=last; d++) {
+            sum     += row[d];
+            mask[d] |= row[d];
+        }
+        perRow[r] = sum;
+    }
+}
+
+
+#if defined(AGGREGATE_X86)
+
+SSE2_TARGET static void sum_sse2(const quint32 *matrix, int rows, int first, int last, quint32 *perRow, quint32 *mask)
+{
+    int r, d;
+    quint32 sum;
+    __m128i acc, v;
+
+    for (r=0; r<rows; r++) {
+        const quint32 *row = matrix + (size_t) r * AGGREGATE_DAYS;
+        acc = _mm_setzero_si128();
+        for (d=first; d+4<=last+1; d+=4) {
+            v   = _mm_loadu_si128((const __m128i*) (row + d));
+            acc = _mm_add_epi32(acc, v);
+            _mm_storeu_si128((__m128i*) (mask + d), _mm_or_si128(_mm_loadu_si128((const __m128i*) (mask + d)), v));
+        }
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+        sum = (quint32) _mm_cvtsi128_si32(acc);
+        for (; d<=last; d++) {
+            sum     += row[d];
+            mask[d] |= row[d];
+        }
+        perRow[r] = sum;
+    }
+}
+
+
+AVX2_TARGET static void sum_avx2(const quint32 *matrix, int rows, int first, int last, quint32 *perRow, quint32 *mask)
+{
+    int r, d;
+    quint32 sum;
+    __m256i acc, v;
+    __m128i half;
+
+    for (r=0; r<rows; r++) {
+        const quint32 *row = matrix + (size_t) r * AGGREGATE_DAYS;
+        acc = _mm256_setzero_si256();
+        for (d=first; d+8<=last+1; d+=8) {
+            v   = _mm256_loadu_si256((const __m256i*) (row + d));
+            acc = _mm256_add_epi32(acc, v);
+            _mm256_storeu_si256((__m256i*) (mask + d), _mm256_or_si256(_mm256_loadu_si256((const __m256i*) (mask + d)), v));
+        }
+        half = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+        sum  = (quint32) _mm_cvtsi128_si32(half);
+        for (; d<=last; d++) {
+            sum     += row[d];
+            mask[d] |= row[d];
+        }
+        perRow[r] = sum;
+    }
+}
+
+
+static void aggregate_cpuid(bool *sse2, bool *avx2)
+{
+// CPUID leaf 1, EDX bit 26: SSE2 - AVX2 needs leaf 7, EBX bit 5 and the OS saving the YMM registers (XGETBV)
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    int maxLeaf = regs[0];
+    __cpuid(regs, 1);
+    *sse2 = (regs[3] & (1 << 26)) != 0;
+    *avx2 = false;
+    if ((regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6 && maxLeaf >= 7) {
+        __cpuidex(regs, 7, 0);
+        *avx2 = (regs[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    *sse2 = __builtin_cpu_supports("sse2");
+    *avx2 = __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // AGGREGATE_X86
+
+
+CAggregate::CAggregate()
+{
+    m_year   = 0;
+    m_rows   = 0;
+    m_kernel = bestKernel();
+}
+
+
+void CAggregate::reset(int year, int rows)
+{
+//  Start over with a matrix of zeros for "rows" tasks in "year"
+    m_year = year;
+    m_rows = rows;
+    m_matrix.fill(0, rows * AGGREGATE_DAYS);
+}
+
+
+void CAggregate::set(int row, const QDate &date, quint32 seconds)
+{
+//  Set the seconds of a task on "date" (dates of other years are ignored)
+    if (date.year() != m_year || row < 0 || row >= m_rows) return;
+
+    m_matrix[row * AGGREGATE_DAYS + date.dayOfYear() - 1] = seconds;
+}
+
+
+void CAggregate::add(int row, const QDate &date, quint32 seconds)
+{
+//  Add to the seconds of a task on "date" (dates of other years are ignored)
+    if (date.year() != m_year || row < 0 || row >= m_rows) return;
+
+    m_matrix[row * AGGREGATE_DAYS + date.dayOfYear() - 1] += seconds;
+}
+
+
+quint64 CAggregate::sum(int first, int last, QVector<quint32> &perRow, int &daysWorked) const
+{
+//  Add up days first .. last (day of the year - 1, both included) per row
+//  perRow: seconds of each row, daysWorked: no. of days with time on any row
+//  Returns the total over all rows
+    quint32 mask[AGGREGATE_DAYS];
+    quint64 total;
+    int i;
+
+    perRow.fill(0, m_rows);
+    daysWorked = 0;
+    first = qMax(first, 0);
+    last  = qMin(last, AGGREGATE_DAYS - 1);
+    if (first > last || m_rows == 0) return 0;
+
+    memset(mask, 0, sizeof(mask));
+    switch (m_kernel) {
+#if defined(AGGREGATE_X86)
+    case AVX2: sum_avx2(m_matrix.constData(), m_rows, first, last, perRow.data(), mask);  break;
+    case SSE2: sum_sse2(m_matrix.constData(), m_rows, first, last, perRow.data(), mask);  break;
+#endif
+    default:   sum_scalar(m_matrix.constData(), m_rows, first, last, perRow.data(), mask);  break;
+    }
+
+    total = 0;
+    for (i=0; i<m_rows; i++) total += perRow.at(i);
+    for (i=first; i<=last; i++) {
+        if (mask[i] != 0) daysWorked++;
+    }
+
+    return total;
+}
+
+
+bool CAggregate::setKernel(eKernel kernel)
+{
+//  Use another kernel (e.g. to compare them) - returns false if the CPU does not support it
+    if (kernel > bestKernel()) return false;
+
+    m_kernel = kernel;
+    return true;
+}
+
+
+CAggregate::eKernel CAggregate::bestKernel()
+{
+//  The fastest kernel the CPU supports (checked once)
+    static const eKernel best = []() {
+#if defined(AGGREGATE_X86)
+        bool sse2, avx2;
+        aggregate_cpuid(&sse2, &avx2);
+        if (avx2) return AVX2;
+        if (sse2) return SSE2;
+#endif
+        return Scalar;
+    }();
+
+    return best;
+}
+
+
+const char *CAggregate::kernelName(eKernel kernel)
+{
+    switch (kernel) {
+    case AVX2: return "avx2";
+    case SSE2: return "sse2";
+    default:   return "scalar";
+    }
+}
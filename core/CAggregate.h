@@ -0,0 +1,61 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CAGGREGATE_H
+#define CAGGREGATE_H
+
+#include <QVector>
+#include <QDate>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define AGGREGATE_X86 1
+#endif
+
+// Days per row: 366 days, padded to a multiple of one AVX2 vector (8 x 32 bit)
+#define AGGREGATE_DAYS 368
+
+
+// Seconds per task per day of one year as dense matrix, for the report sums
+//
+// One row of AGGREGATE_DAYS seconds per task (index: day of the year - 1). The sums over a window of days - per task,
+// in total & the no. of days with time on any task - are computed in one sweep over the rows: each row segment is added
+// up and OR-ed into a mask of the days worked. SSE2 & AVX2 kernels are selected at runtime, a scalar one elsewhere.
+// A row adds up at most 366 x 86400 seconds, so 32 bit lanes do not overflow; the total is 64 bit.
+class CAggregate
+{
+public:
+    enum eKernel { Scalar, SSE2, AVX2 };
+
+    CAggregate();
+
+    void reset(int year, int rows);
+    int  year() const { return m_year; }
+    int  rows() const { return m_rows; }
+    void set(int row, const QDate &date, quint32 seconds);
+    void add(int row, const QDate &date, quint32 seconds);
+    quint64 sum(int first, int last, QVector<quint32> &perRow, int &daysWorked) const;
+
+    eKernel kernel() const { return m_kernel; }
+    bool    setKernel(eKernel kernel);
+    static eKernel bestKernel();
+    static const char *kernelName(eKernel kernel);
+
+private:
+    QVector<quint32> m_matrix;   // rows x AGGREGATE_DAYS
+    int     m_year;              // 0: no year
+    int     m_rows;
+    eKernel m_kernel;
+};
+
+#endif // CAGGREGATE_H
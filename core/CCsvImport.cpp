@@ -0,0 +1,247 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <math.h>
+#include <QFile>
+#include <QSet>
+#include "CCsvImport.h"
+#include "CTrace.h"
+
+
+CCsvImport::CCsvImport()
+{
+    clear();
+}
+
+
+void CCsvImport::clear()
+{
+    titles.clear();
+    index.clear();
+    times.clear();
+    m_format  = Wide;
+    m_lines   = 0;
+    m_entries = 0;
+    m_error.clear();
+}
+
+
+bool CCsvImport::readFile(const QString &file)
+{
+//  Read a CSV file (UTF-8) into the staging area
+    QFile csvfile(file);
+
+    clear();
+    if (!csvfile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        m_error = "Could not open " + file;
+        return false;
+    }
+    QTextStream in(&csvfile);
+    in.setCodec("UTF-8");
+
+    return read(in);
+}
+
+
+bool CCsvImport::read(QTextStream &in)
+{
+//  Read CSV data into the staging area, one line at a time (no store is changed)
+//  Returns false on the first line that cannot be read, error() tells which
+    QStringList fields;
+    QVector<int> columns;
+    QDate   date;
+    quint32 seconds;
+    int     i, t;
+    TRACE_SCOPE("CCsvImport::read");
+
+    clear();
+
+    // Header - decides the format:
+    if (!readRecord(in, fields)) return fail("File is empty");
+    for (i=0; i<fields.count(); i++) fields[i] = fields.at(i).trimmed();
+    if (fields.count() < 2 || fields.at(0).compare("Date", Qt::CaseInsensitive) != 0) {
+        return fail("Header must be \"Date,<task>,...\" or \"Date,Task,Hours\"");
+    }
+    if (fields.count() == 3 && fields.at(1).compare("Task", Qt::CaseInsensitive) == 0 && fields.at(2).compare("Hours", Qt::CaseInsensitive) == 0) {
+        m_format = Long;
+    }
+    else {
+        m_format = Wide;
+        for (i=1; i<fields.count(); i++) {
+            if (fields.at(i).isEmpty()) return fail(QString("Task title of column %1 is empty").arg(i + 1));
+            columns.append(task(fields.at(i)));
+        }
+    }
+
+    while (readRecord(in, fields)) {
+        if (fields.count() == 1 && fields.at(0).trimmed().isEmpty()) continue;   // Empty line
+
+        if (m_format == Wide) {
+            if (fields.count() != columns.count() + 1) return fail(QString("Expected %1 fields, found %2").arg(columns.count() + 1).arg(fields.count()));
+            if (!parseDate(fields.at(0), date)) return fail("Invalid date: " + fields.at(0));
+            for (i=0; i<columns.count(); i++) {
+                if (!parseHours(fields.at(i + 1), seconds)) return fail("Invalid time: " + fields.at(i + 1));
+                if (seconds == 0) continue;
+                times[columns.at(i)][date] += seconds;
+                m_entries++;
+            }
+        }
+        else {
+            if (fields.count() != 3) return fail(QString("Expected 3 fields, found %1").arg(fields.count()));
+            if (!parseDate(fields.at(0), date)) return fail("Invalid date: " + fields.at(0));
+            if (fields.at(1).trimmed().isEmpty()) return fail("Task title is empty");
+            if (!parseHours(fields.at(2), seconds)) return fail("Invalid time: " + fields.at(2));
+            if (seconds == 0) continue;
+            t = task(fields.at(1).trimmed());
+            times[t][date] += seconds;
+            m_entries++;
+        }
+    }
+
+    return true;
+}
+
+
+int CCsvImport::missingTasks(const CTaskStore &store) const
+{
+//  No. of tasks apply() will append to the store (tasks are matched by title)
+    QSet<QString> existing;
+    int i, missing;
+
+    for (i=0; i<store.count(); i++) {
+        existing.insert(store.title(i));
+    }
+    missing = 0;
+    for (i=0; i<titles.count(); i++) {
+        if (!existing.contains(titles.at(i))) missing++;
+    }
+    return missing;
+}
+
+
+int CCsvImport::apply(CTaskStore &store) const
+{
+//  Put the staged entries into the store in one go (replacing the times of the same task & day)
+//  Returns the no. of tasks appended
+    return store.importTimes(titles, times);
+}
+
+
+int CCsvImport::task(const QString &title)
+{
+//  Position of a task in the staging area, added if it is new
+    int t;
+
+    t = index.value(title, -1);
+    if (t < 0) {
+        t = titles.count();
+        titles.append(title);
+        times.append(QMap<QDate, quint32>());
+        index.insert(title, t);
+    }
+    return t;
+}
+
+
+bool CCsvImport::fail(const QString &message)
+{
+    m_error = QString("Line %1: %2").arg(m_lines).arg(message);
+    return false;
+}
+
+
+bool CCsvImport::readRecord(QTextStream &in, QStringList &fields)
+{
+//  Read one record, split into fields (a quoted field may contain commas, "" for a quote and line feeds)
+//  Returns false at the end of the data
+    QString line, field;
+    bool    quoted;
+    int     i;
+
+    fields.clear();
+    if (!in.readLineInto(&line)) return false;
+    m_lines++;
+
+    quoted = false;
+    i = 0;
+    do {
+        for (; i<line.length(); i++) {
+            const QChar c = line.at(i);
+            if (quoted) {
+                if (c != '"')                                       field += c;
+                else if (i + 1 < line.length() && line.at(i + 1) == '"') { field += c; i++; }
+                else                                                quoted = false;
+            }
+            else if (c == '"') quoted = true;
+            else if (c == ',') {
+                fields.append(field);
+                field.clear();
+            }
+            else field += c;
+        }
+
+        // Line feed within a quoted field - the record goes on in the next line:
+        if (quoted) {
+            if (!in.readLineInto(&line)) break;
+            m_lines++;
+            field += '\n';
+            i = 0;
+        }
+    } while (quoted);
+    fields.append(field);
+
+    return true;
+}
+
+
+bool CCsvImport::parseDate(const QString &text, QDate &date)
+{
+//  dd.MM.yyyy (as exported) or yyyy-MM-dd
+    QString s = text.trimmed();
+
+    date = QDate::fromString(s, "dd.MM.yyyy");
+    if (!date.isValid()) date = QDate::fromString(s, Qt::ISODate);
+    return date.isValid();
+}
+
+
+bool CCsvImport::parseHours(const QString &text, quint32 &seconds)
+{
+//  Decimal hours (1.5) or h:mm[:ss]; empty is 0
+    QString s = text.trimmed();
+    QStringList parts;
+    double  hours;
+    int     h, m, sec;
+    bool    ok, okM, okS;
+
+    seconds = 0;
+    if (s.isEmpty()) return true;
+
+    if (s.contains(':')) {
+        parts = s.split(':');
+        if (parts.count() > 3) return false;
+        h   = parts.at(0).toInt(&ok);
+        m   = parts.at(1).toInt(&okM);
+        sec = parts.count() == 3 ? parts.at(2).toInt(&okS) : 0;
+        if (parts.count() < 3) okS = true;
+        if (!ok || !okM || !okS || h < 0 || m < 0 || m > 59 || sec < 0 || sec > 59 || h > 1000000) return false;
+        seconds = (quint32) h * 3600 + m * 60 + sec;
+        return true;
+    }
+
+    hours = s.toDouble(&ok);   // Always '.' as decimal point, like the export
+    if (!ok || hours < 0.0 || hours > 1000000.0) return false;
+    seconds = (quint32) llround(hours * 3600.0);
+    return true;
+}
@@ -0,0 +1,73 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CCSVIMPORT_H
+#define CCSVIMPORT_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QDate>
+#include <QTextStream>
+#include "CTaskStore.h"
+
+
+// Streaming CSV import, the inverse of CTaskStore::writeCsv()
+//
+// Two formats are recognized by their header line:
+//   Wide (as exported):  Date,<task>,<task>,...    one line per day, the hours of each task in its column
+//   Long:                Date,Task,Hours           one line per entry (several entries of a task on one day are added up)
+// Dates are dd.MM.yyyy or yyyy-MM-dd, hours are decimal (1.5) or h:mm[:ss]; fields may be quoted as in RFC 4180.
+//
+// read() takes the file one line at a time into a staging area (seconds per task & day), so the memory needed depends on
+// the no. of task days imported, not on the size of the file. Nothing is changed before the whole file was read without
+// error; apply() then puts all entries into the store at once (see CTaskStore::importTimes()) and recomputes the times once.
+class CCsvImport
+{
+public:
+    enum Format { Wide, Long };
+
+    CCsvImport();
+
+    bool readFile(const QString &file);
+    bool read(QTextStream &in);
+    int  missingTasks(const CTaskStore &store) const;
+    int  apply(CTaskStore &store) const;
+
+    Format  format() const  { return m_format; }
+    qint64  lines() const   { return m_lines; }
+    qint64  entries() const { return m_entries; }
+    int     tasks() const   { return titles.count(); }
+    QString error() const   { return m_error; }
+
+private:
+    QStringList                 titles;    // Tasks in the file, in order of appearance
+    QHash<QString, int>         index;     // Title -> position in titles & times
+    QVector<QMap<QDate, quint32>> times;   // Seconds per day of each task
+    Format  m_format;
+    qint64  m_lines;       // Lines read so far (for error messages)
+    qint64  m_entries;     // Non-zero values read
+    QString m_error;
+
+    void clear();
+    int  task(const QString &title);
+    bool fail(const QString &message);
+    bool readRecord(QTextStream &in, QStringList &fields);
+    static bool parseDate(const QString &text, QDate &date);
+    static bool parseHours(const QString &text, quint32 &seconds);
+};
+
+#endif // CCSVIMPORT_H
@@ -0,0 +1,107 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CLOCKFREE_H
+#define CLOCKFREE_H
+
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+#include <QAtomicInteger>
+
+
+// Bounded queue between exactly one producer thread and one consumer thread (Size must be a power of 2).
+// Neither side ever blocks: push() fails if the queue is full, pop() if it is empty.
+template <typename T, int Size>
+class CSpscQueue
+{
+    static_assert(Size > 0 && (Size & (Size - 1)) == 0, "CSpscQueue: Size must be a power of 2");
+
+public:
+    CSpscQueue() : head(0), tail(0) {}
+
+    // Producer only
+    bool push(const T &item) {
+        quint32 t = tail.load();
+        if (t - head.loadAcquire() == (quint32) Size) return false;
+        items[t & (Size - 1)] = item;
+        tail.storeRelease(t + 1);
+        return true;
+    }
+
+    // Consumer only
+    bool pop(T &item) {
+        quint32 h = head.load();
+        if (tail.loadAcquire() == h) return false;
+        item = items[h & (Size - 1)];
+        head.storeRelease(h + 1);
+        return true;
+    }
+
+    bool isEmpty() const { return tail.loadAcquire() == head.loadAcquire(); }
+
+private:
+    T items[Size];
+    alignas(64) QAtomicInteger<quint32> head;   // Next item to pop (written by the consumer)
+    alignas(64) QAtomicInteger<quint32> tail;   // Next free slot (written by the producer)
+};
+
+
+// Value published by one writer thread and read by any no. of threads without locks (sequence lock).
+// The writer never waits; a reader retries while a store() is in progress. T must be trivially copyable.
+template <typename T>
+class CSeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "CSeqLock: T must be trivially copyable");
+
+public:
+    CSeqLock() : seq(0) {}
+
+    // Writer only
+    void store(const T &value) {
+        quint64 buffer[Words];
+        quint32 s = seq.load();
+        int i;
+
+        memset(buffer, 0, sizeof(buffer));
+        memcpy(buffer, &value, sizeof(T));
+        seq.store(s + 1);                                      // Odd: being written
+        std::atomic_thread_fence(std::memory_order_release);
+        for (i = 0; i < Words; i++) words[i].store(buffer[i]);
+        seq.storeRelease(s + 2);
+    }
+
+    T load() const {
+        quint64 buffer[Words];
+        quint32 s1, s2;
+        T value;
+        int i;
+
+        do {
+            s1 = seq.loadAcquire();
+            for (i = 0; i < Words; i++) buffer[i] = words[i].load();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            s2 = seq.load();
+        } while ((s1 & 1) || s1 != s2);
+        memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+private:
+    enum { Words = (sizeof(T) + 7) / 8 };
+    QAtomicInteger<quint32> seq;
+    QAtomicInteger<quint64> words[Words];
+};
+
+#endif // CLOCKFREE_H
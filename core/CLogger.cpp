@@ -0,0 +1,180 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <QDateTime>
+#include <QMutexLocker>
+#include "CLogger.h"
+
+
+CLogger::CLogger()
+{
+    ring.resize(LOG_BUFFER_SIZE);
+    head     = 0;
+    count    = 0;
+    dropped  = 0;
+    posted   = 0;
+    written  = 0;
+    running  = false;
+    stop     = false;
+    minLevel = Info;
+    maxSize  = LOG_MAX_SIZE;
+    keep     = LOG_KEEP;
+}
+
+
+CLogger::~CLogger()
+{
+    close();
+}
+
+
+bool CLogger::open(const QString &file, qint64 maxSize, int keep)
+{
+//  Open the log file (appending to it) and start the writer thread
+    close();
+
+    this->maxSize = maxSize;
+    this->keep    = keep;
+    path = file;
+    logFile.setFileName(file);
+    if (!logFile.open(QIODevice::WriteOnly | QIODevice::Append)) return false;
+    if (logFile.size() >= maxSize) rotate();
+
+    stop    = false;
+    running = true;
+    start(QThread::LowPriority);
+
+    return true;
+}
+
+
+void CLogger::close()
+{
+//  Write what is left and stop the writer thread
+    if (!running) return;
+
+    mutex.lock();
+    stop = true;
+    wake.wakeOne();
+    mutex.unlock();
+    wait();
+
+    running = false;
+    logFile.close();
+}
+
+
+void CLogger::flush()
+{
+//  Wait until everything posted so far is on disk (for a crash or before reading the file)
+    QMutexLocker lock(&mutex);
+    quint32 target = posted;
+
+    while (running && (qint32) (written - target) < 0) {
+        wake.wakeOne();
+        done.wait(&mutex, 100);
+    }
+}
+
+
+void CLogger::post(Level level, const QByteArray &text)
+{
+//  Queue a record - only takes the lock for the copy, never waits for the writer
+    QMutexLocker lock(&mutex);
+
+    if (count == ring.size()) {
+        dropped++;
+        return;
+    }
+    sRecord &record = ring[(head + count) % ring.size()];
+    record.time  = QDateTime::currentMSecsSinceEpoch();
+    record.level = level;
+    record.text  = text;
+    count++;
+    posted++;
+    wake.wakeOne();
+}
+
+
+void CLogger::run()
+{
+//  Writer thread: take all waiting records at once, format & write them, flush once per batch
+    static const char *levels[] = { "Debug", "Info", "Warning", "Error" };
+    QVector<sRecord> batch;
+    QByteArray out;
+    quint32 lost;
+    bool    last;
+    int     i;
+
+    batch.reserve(LOG_BUFFER_SIZE);
+    do {
+        mutex.lock();
+        while (count == 0 && dropped == 0 && !stop) wake.wait(&mutex);
+        for (i = 0; i < count; i++) {
+            batch.append(ring.at((head + i) % ring.size()));
+            ring[(head + i) % ring.size()].text.clear();
+        }
+        head  = (head + count) % ring.size();
+        count = 0;
+        lost    = dropped;
+        dropped = 0;
+        last    = stop;
+        mutex.unlock();
+
+        for (i = 0; i < batch.count(); i++) {
+            out.append(QDateTime::fromMSecsSinceEpoch(batch.at(i).time).toString("dd.MM.yyyy - HH:mm:ss.zzz").toUtf8());
+            out.append(" [");
+            out.append(levels[batch.at(i).level]);
+            out.append("] ");
+            out.append(batch.at(i).text);
+            out.append('\n');
+        }
+        if (lost > 0) {
+            out.append(QDateTime::currentDateTime().toString("dd.MM.yyyy - HH:mm:ss.zzz").toUtf8());
+            out.append(" [Warning] Log buffer full - ");
+            out.append(QByteArray::number(lost));
+            out.append(" records dropped\n");
+        }
+        if (logFile.size() + out.size() > maxSize && logFile.size() > 0) rotate();
+        logFile.write(out);
+        logFile.flush();
+
+        mutex.lock();
+        written += batch.count();
+        done.wakeAll();
+        mutex.unlock();
+
+        batch.clear();
+        out.clear();
+    } while (!last);
+}
+
+
+void CLogger::rotate()
+{
+//  <file>.(keep-1) -> <file>.keep, ..., <file> -> <file>.1, then start a new file
+    QString name;
+    int     i;
+
+    name = logFile.fileName();
+    logFile.close();
+    QFile::remove(QString("%1.%2").arg(name).arg(keep));
+    for (i = keep - 1; i >= 1; i--) {
+        QFile::rename(QString("%1.%2").arg(name).arg(i), QString("%1.%2").arg(name).arg(i + 1));
+    }
+    if (keep > 0) QFile::rename(name, name + ".1");
+    else          QFile::remove(name);
+    logFile.setFileName(name);
+    logFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
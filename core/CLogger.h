@@ -0,0 +1,111 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CLOGGER_H
+#define CLOGGER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
+#include <QByteArray>
+#include <QString>
+#include <QFile>
+
+// Records kept until the writer thread gets to them - further records are dropped (and counted) while the buffer is full
+#define LOG_BUFFER_SIZE  1024
+// The log file is rotated when it reaches this size (in Bytes), keeping LOG_KEEP old files ("<file>.1" is the newest)
+#define LOG_MAX_SIZE     (1024*1024)
+#define LOG_KEEP         3
+
+
+// Asynchronous log file writer
+//
+// Callers only append a record (time stamp, level, message) to a ring buffer; a background thread formats the records,
+// writes them in batches and rotates the file by size. So logging never waits for the disk, wherever it is called from.
+// Usage:  logger.warning() << "load_data(): Could not read save file: " << File;
+// The record is posted when the temporary goes out of scope, i.e. at the end of the statement.
+class CLogger : public QThread
+{
+public:
+    enum Level { Debug = 0, Info, Warning, Error };
+
+    // Collects the message of one record
+    class Record {
+    public:
+        Record(CLogger *logger, Level level) : logger(logger), level(level) {}
+        Record(Record &&other) : logger(other.logger), level(other.level), text(other.text) { other.logger = nullptr; }
+        Record(const Record &) = delete;
+        ~Record() { if (logger) logger->post(level, text); }
+        Record &operator<<(const char *s)         { if (logger) text.append(s); return *this; }
+        Record &operator<<(const QString &s)      { if (logger) text.append(s.toUtf8()); return *this; }
+        Record &operator<<(const QByteArray &s)   { if (logger) text.append(s); return *this; }
+        Record &operator<<(int n)                 { if (logger) text.append(QByteArray::number(n)); return *this; }
+        Record &operator<<(unsigned int n)        { if (logger) text.append(QByteArray::number(n)); return *this; }
+        Record &operator<<(qint64 n)              { if (logger) text.append(QByteArray::number(n)); return *this; }
+        Record &operator<<(quint64 n)             { if (logger) text.append(QByteArray::number(n)); return *this; }
+    private:
+        CLogger   *logger;   // Null if the level is filtered out
+        Level      level;
+        QByteArray text;
+    };
+
+    CLogger();
+    ~CLogger();
+
+    bool    open(const QString &file, qint64 maxSize = LOG_MAX_SIZE, int keep = LOG_KEEP);
+    void    close();
+    void    flush();
+    void    setLevel(Level level) { minLevel = level; }
+    QString fileName() const { return path; }
+
+    Record write(Level level) { return Record(level >= minLevel && running ? this : nullptr, level); }
+    Record debug()   { return write(Debug); }
+    Record info()    { return write(Info); }
+    Record warning() { return write(Warning); }
+    Record error()   { return write(Error); }
+
+    void post(Level level, const QByteArray &text);
+
+protected:
+    void run() override;
+
+private:
+    struct sRecord {
+        qint64     time;    // ms since epoch
+        Level      level;
+        QByteArray text;
+    };
+    QVector<sRecord> ring;
+    int     head;           // Next record to write to disk
+    int     count;          // Records waiting
+    quint32 dropped;        // Records lost since the last batch because the buffer was full
+    quint32 posted;         // Records posted so far - flush() waits for "written" to catch up
+    quint32 written;
+    bool    running;
+    bool    stop;
+    Level   minLevel;
+    QMutex  mutex;
+    QWaitCondition wake;    // New records or stop
+    QWaitCondition done;    // A batch was written
+
+    QString path;
+    QFile   logFile;           // Only used by the writer thread while running
+    qint64  maxSize;
+    int     keep;
+
+    void rotate();
+};
+
+#endif // CLOGGER_H
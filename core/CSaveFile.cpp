@@ -0,0 +1,1952 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <QSet>
+#include <QTime>
+#include <QRandomGenerator>
+#include "CSaveFile.h"
+#include "CTrace.h"
+#if defined(Q_OS_WIN)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+CSaveFile::CSaveFile(CTaskStore &store, CLogger &logger, QObject *parent) : QObject(parent), store(store), logger(logger)
+{
+    quint32 random_number;
+    int     i;
+
+    loadGeneration                = 0;
+    decrypting                    = false;
+
+    activeFile.SaveFileName       = "";
+    activeFile.SaveFileNameFull   = "";
+    activeFile.magic_no           = 0x00000000;
+    activeFile.version_no         = 0;
+    activeFile.encrypted          = 0;
+    memset(activeFile.PasswordHashRead, 0, 32);
+
+    newFile.SaveFileName          = "";
+    newFile.SaveFileNameFull      = "";
+    newFile.magic_no              = 0x00000000;
+    newFile.version_no            = 0;
+    newFile.encrypted             = 0;
+    memset(newFile.PasswordHashRead, 0, 32);
+
+    // Keep the key material out of swap:
+    keyCached = 0;
+    memset(key, 0, 32);
+    if (!secure_lock(key, sizeof(key)) || !secure_lock(&chunks, sizeof(chunks)) || !secure_lock(digestKey, sizeof(digestKey))) {
+        qWarning("Could not lock key memory!");
+        logger.warning() << "Ctor: Could not lock key memory!";
+    }
+    // The page digests only have to match within this session:
+    for (i=0; i<32; i+=4) {
+        random_number = QRandomGenerator::global()->generate();
+        memcpy(&digestKey[i], &random_number, 4);
+    }
+
+    connect(&loadWatcher, &QFutureWatcher<void>::finished, this, &CSaveFile::finishLoad);
+
+}
+
+CSaveFile::~CSaveFile()
+{
+
+    // Stop a running load job (it reports to this object):
+    if (loadWatcher.isRunning()) {
+        loadJob->cancel.storeRelease(1);
+        loadWatcher.waitForFinished();
+    }
+    loadJob.clear();
+
+    // Wipe the key material:
+    invalidateKeyCache();
+    clean(digestKey, 32);
+    secure_unlock(key, sizeof(key));
+    secure_unlock(&chunks, sizeof(chunks));
+    secure_unlock(digestKey, sizeof(digestKey));
+}
+
+
+bool CSaveFile::checkFileType(const QString &File)
+{
+// Find out if the save file given in "File" is encrypted or not
+// Returns false if no file name was given; otherwise pending() holds the names (empty if the file can't be loaded)
+    QFile   infile;
+
+    if (File.isEmpty()) {
+        qWarning("checkFileType(): No file name given!");
+        logger.warning() << "checkFileType(): No file name given!";
+        return false;
+    }
+
+    newFile.SaveFileNameFull = File;
+    newFile.SaveFileName     = File.section("/",-1);
+
+    infile.setFileName(File);
+
+    if (!infile.open(QIODevice::ReadOnly)) {
+        qWarning("checkFileType(): Could not read save file - %s!",File.toUtf8().data());
+        logger.warning() << "checkFileType(): Could not read save file: " << File;
+        newFile.SaveFileNameFull = "";
+        newFile.SaveFileName     = "";
+    }
+    else {
+        QDataStream in(&infile);
+        in.setVersion(QDataStream::Qt_5_0);
+
+        // Read magic number
+        in >> newFile.magic_no;       //qInfo("Magic no. = %X",newFile.magic_no);
+        if (newFile.magic_no == 0x051076B0) {
+            newFile.encrypted = 1;
+            emit passwordNeeded(1);
+        }
+        else if (newFile.magic_no == 0x051076A0) {
+            newFile.encrypted = 0;
+            emit passwordNeeded(0);
+        }
+        else {
+            qWarning("checkFileType(): Bad save file format - %s!",File.toUtf8().data());
+            logger.warning() << "checkFileType(): Bad save file format: " << File;
+            newFile.SaveFileNameFull = "";
+            newFile.SaveFileName     = "";
+            emit passwordNeeded(0);
+        }
+        infile.close();
+    }
+    //qInfo("SaveFileName = %s   SaveFileNameFull = %s",newFile.SaveFileName.toUtf8().data(),newFile.SaveFileNameFull.toUtf8().data());
+
+    return true;
+}
+
+void CSaveFile::load_data(const QString &PW, const QString &File)
+{
+//  Find out if a data file is encrypted or not, then load it
+//  Encrypted files are loaded asynchronously - loaded() is emitted in any case once the data is in place (or loading failed)
+    int     i, fileGood, status;
+    bool    ok;
+    QFile   infile;
+    TRACE_SCOPE("CSaveFile::load_data");
+
+    newFile.Password = PW;
+    //qInfo("load_data:  Password= %s   File= %s",newFile.Password.toUtf8().data(),File.toUtf8().data());
+
+    memset(newFile.PasswordHashRead, 0, 32);
+    fileGood = 1;
+    status   = 3;
+
+    // An interrupted incremental save is completed (or discarded) first - if that fails, the file does not authenticate:
+    replayJournal(File);
+
+    // Find out if the save file is encrypted or not:
+    infile.setFileName(File);
+
+    if (!infile.open(QIODevice::ReadOnly)) {
+        qWarning("load_data(): Could not read save file - %s!",File.toUtf8().data());
+        logger.warning() << "load_data(): Could not read save file: " << File;
+        newFile.SaveFileNameFull = "";
+        newFile.SaveFileName     = "";
+        fileGood = 0;
+    }
+    else {
+        QDataStream in(&infile);
+        in.setVersion(QDataStream::Qt_5_0);
+
+        // Read magic number
+        in >> newFile.magic_no;       //qInfo("Magic no. = %X",magic_no);
+        if (newFile.magic_no == 0x051076B0) {
+            newFile.encrypted = 1;
+            fileGood = 1;
+            emit passwordNeeded(1);
+        }
+        else if (newFile.magic_no == 0x051076A0) {
+            newFile.encrypted = 0;
+            fileGood = 1;
+            emit passwordNeeded(0);
+        }
+        else {
+            qWarning("Bad save file format - %s!",File.toUtf8().data());
+            logger.warning() << "load_data(): Bad save file format: " << File;
+            newFile.SaveFileNameFull = "";
+            newFile.SaveFileName     = "";
+            fileGood = 0;
+        }
+        // Version no. selects the key derivation for encrypted files:
+        in >> newFile.version_no;
+        if (fileGood && newFile.encrypted && (newFile.version_no < 100 || newFile.version_no > 103)) {
+            qWarning("Bad save file version - %s!",File.toUtf8().data());
+            logger.warning() << "load_data(): Bad save file version: " << File;
+            newFile.SaveFileNameFull = "";
+            newFile.SaveFileName     = "";
+            fileGood = 0;
+        }
+        // Read salt & password hash
+        for (i=0; i<16; i++) {
+            in >> newFile.salt[i];
+        }
+        for (i=0; i<32; i++) {
+            in >> newFile.PasswordHashRead[i];
+        }
+        infile.close();
+    }
+
+    //qInfo("salt:  %02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x",
+    //      salt[0],salt[1],salt[2],salt[3],salt[4],salt[5],salt[6],salt[7],salt[8],salt[9],salt[10],salt[11],salt[12],salt[13],salt[14],salt[15]);
+    //qInfo("PasswordHash:  %02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x",
+    //      PasswordHashRead[0],PasswordHashRead[1],PasswordHashRead[2],PasswordHashRead[3],PasswordHashRead[4],PasswordHashRead[5],PasswordHashRead[6],PasswordHashRead[7],PasswordHashRead[8],PasswordHashRead[9],PasswordHashRead[10],PasswordHashRead[11],PasswordHashRead[12],PasswordHashRead[13],PasswordHashRead[14],PasswordHashRead[15]);
+
+
+    if (fileGood) {
+        if (newFile.encrypted) {
+            // Read the encrypted save file
+            // Password check, key derivation and decryption run in a worker thread, finishLoad() takes over from there:
+            if (loadWatcher.isRunning()) {
+                // A job still running for a previous password entry is obsolete - it stops at its next progress check
+                loadJob->cancel.storeRelease(1);
+                loadWatcher.waitForFinished();
+            }
+
+            loadJob = QSharedPointer<sLoadJob>(new sLoadJob());
+            loadJob->file       = newFile;
+            loadJob->filename   = File;
+            loadJob->owner      = this;
+            loadJob->generation = ++loadGeneration;
+            loadJob->arena      = &loadArena;
+            memcpy(loadJob->digestKey, digestKey, 32);
+            loadJob->reader.today     = store.today();
+            loadJob->reader.thisMonth = store.thisMonth();
+            loadJob->reader.thisYear  = store.thisYear();
+
+            decrypting = true;
+            emit loadStarted();
+
+            loadWatcher.setFuture(QtConcurrent::run(&CSaveFile::decryptfile, loadJob));
+            return;
+        }
+        else {
+            // Read the unencrypted save file - the tasks are replaced even if this fails
+            QList<Task> tasks;
+            emit tasksAboutToBeReplaced();
+            close();
+            ok = readfile(File, tasks);
+            store.setTasks(tasks);
+            emit tasksReplaced();
+            if (!ok) {
+                qWarning("Could not read save file %s!",File.toUtf8().data());
+                logger.warning() << "load_data(): Could not read save file: " << File;
+                newFile.SaveFileName     = "";
+                newFile.SaveFileNameFull = "";
+            }
+            else {
+                // Update the active file only when everything went OK
+                activeFile       = newFile;
+                status = 0;
+            }
+        }
+    }
+    else {
+        // File could not be read OR bad magic no.
+        // We already have log file outputs for each of the cases before.
+    }
+
+
+    //store.checkEntries(5);   // Debug
+
+    newFile.Password = "";
+    emit loaded(status);
+
+}
+
+
+void CSaveFile::cancelLoad()
+{
+// Abort loading an encrypted file (e.g. user clicked Cancel in the password dialog)
+// The worker stops at its next check, finishLoad() then reports status 2
+    if (!loadJob.isNull() && decrypting) {
+        loadJob->cancel.storeRelease(1);
+        logger.info() << "cancelLoad(): Loading cancelled by user.";
+    }
+}
+
+
+CSaveFile::sLoadJob::sLoadJob() : cancel(0)
+{
+    generation   = 0;
+    status       = 3;
+    lastProgress = -1;
+    owner        = nullptr;
+    arena        = nullptr;
+    memset(key, 0, 32);
+    memset(digestKey, 0, 32);
+    secure_lock(key, sizeof(key));
+    secure_lock(digestKey, sizeof(digestKey));
+}
+
+
+CSaveFile::sLoadJob::~sLoadJob()
+{
+    clean(key, 32);
+    clean(digestKey, 32);
+    secure_unlock(key, sizeof(key));
+    secure_unlock(digestKey, sizeof(digestKey));
+}
+
+
+void CSaveFile::decryptfile(QSharedPointer<sLoadJob> job)
+{
+// Runs in a worker thread: check the password, derive the key, decrypt the save file and decode the tasks into job->reader.
+// Only the job object is written here; job->owner is only used to post progress reports to its thread.
+// The file is read into a buffer of LOAD_WINDOW Bytes at a time, decrypted in place and decoded from there, so loading needs
+// no memory in proportion to the file size besides the tasks themselves.
+// Status 4: a chunk/page of a version 102/103 file failed authentication (damaged, modified or truncated file) or the key is wrong.
+    int     len;
+    qint64  size_cipher, pos, n, begin, end;
+    size_t  size_sealed, size_plain, stride;
+    quint32 chunk_count, first, chunk_n, k;
+    quint32 page_count, page, slot_first, slot_end, slot_pages, record_len, remaining, offset, piece;
+    uint8_t passwordHash[32];
+    uint8_t header[54];
+    uint8_t meta[PAGED_META_SIZE];
+    uint8_t root[CHUNK_TAG_SIZE];
+    uint8_t fileNonce[CHUNK_NONCE_SIZE];
+    uint8_t digest[PAGE_DIGEST_SIZE];
+    uint8_t *data;
+    SHA256  hash;
+    CBC<AES256> decrypter;
+    ChunkCipher opener;
+    QFile   readfile;
+    uint8_t *window;
+    size_t  window_size;
+    QByteArray digests;
+    TRACE_SCOPE("CSaveFile::decryptfile");
+
+    // Hash the given password and compare with saved one:
+    len = 32;
+    if (job->file.Password.length()<32) len = job->file.Password.length();   // Use only the first 32 Bytes
+    hash.update(job->file.Password.toUtf8().data(), len);
+    hash.finalize(&passwordHash[0], 32);
+    if (memcmp(&passwordHash[0], &(job->file.PasswordHashRead[0]), 32) != 0) {
+        job->status = 1;
+        return;
+    }
+
+    // Derive the key (first 90% of the progress):
+    if (deriveKey(job->file.Password, job->file.salt, job->file.version_no, &(job->key[0]), &CSaveFile::loadProgress, job.data()) != 0) {
+        job->status = job->cancel.loadAcquire() ? 2 : 3;
+        return;
+    }
+
+    // Read encrypted data
+    readfile.setFileName(job->filename);
+    if (!readfile.open(QIODevice::ReadOnly)) {
+        job->status = 3;
+        return;
+    }
+    // Magic no., version no., salt & hash (parsed in load_data() already):
+    if (readfile.read((char*) header, 54) != 54) {
+        job->status = 3;
+        return;
+    }
+
+    // Decryption & decoding take the last 10% of the progress, a cancel request is checked after every window.
+    // The window comes from the owner's load arena (only one job runs at a time) and is wiped at the end of this function.
+    job->status = 0;
+    if (job->file.version_no >= 103) {
+        // Paged format: page count, page size, save counter & root tag, followed by the pages
+        if (readfile.read((char*) meta, PAGED_META_SIZE) != PAGED_META_SIZE) {
+            job->status = 4;
+            return;
+        }
+        page_count = qFromBigEndian<quint32>(meta);
+        if (qFromBigEndian<quint32>(meta + 4) != CHUNK_PAGE_SIZE || readfile.size() - PAGED_DATA_START != (qint64) page_count * CHUNK_PAGE_STORED) {
+            job->status = 4;   // Truncated or extended
+            return;
+        }
+        opener.setKey(job->key, 32);
+        opener.setHeader(header, 54);
+        job->layout.pageCount   = page_count;
+        job->layout.saveCounter = qFromBigEndian<quint64>(meta + 8);
+        job->layout.file        = job->filename;
+        job->layout.tags.resize(page_count * CHUNK_TAG_SIZE);
+        window_size = qMin(page_count, (quint32) (LOAD_WINDOW / CHUNK_PAGE_STORED)) * CHUNK_PAGE_STORED;
+        window      = (uint8_t*) job->arena->alloc(window_size);
+        if (window == NULL) job->status = 3;
+
+        // Walk the slots page by page: the first page of each slot holds its size and the length of the task record (0: unused slot).
+        // The record follows and may continue on the next pages (and in the next window). Only a digest of each page is kept
+        // for saving incrementally, the plaintext is gone with the window.
+        slot_first = 0;
+        slot_end   = 0;
+        remaining  = 0;
+        for (first = 0; first < page_count && job->status == 0; first += chunk_n) {
+            chunk_n = qMin(page_count - first, (quint32) (window_size / CHUNK_PAGE_STORED));
+            if (readfile.read((char*) window, (qint64) chunk_n * CHUNK_PAGE_STORED) != (qint64) chunk_n * CHUNK_PAGE_STORED) {
+                job->status = 3;
+                break;
+            }
+            for (k = 0; k < chunk_n; k++) {
+                memcpy(job->layout.tags.data() + (first + k) * CHUNK_TAG_SIZE, window + (size_t) k * CHUNK_PAGE_STORED + CHUNK_PAGE_NONCE + CHUNK_PAGE_SIZE, CHUNK_TAG_SIZE);
+            }
+            CTraceScope decrypt("decryptfile: openPages");
+            if (!opener.openPages(window, first, chunk_n)) {
+                job->status = 4;
+                break;
+            }
+            decrypt.end();
+            for (k = 0; k < chunk_n && job->status == 0; k++) {
+                page = first + k;
+                data = window + (size_t) k * CHUNK_PAGE_STORED + CHUNK_PAGE_NONCE;
+                offset = 0;
+                if (page == slot_end) {
+                    memcpy(&slot_pages, data, 4);
+                    memcpy(&record_len, data + 4, 4);
+                    if (slot_pages == 0 || slot_pages > page_count - page || (record_len > 0 && (record_len < 257 || record_len > slot_pages * CHUNK_PAGE_SIZE - 8))) {
+                        job->status = 3;   // Authentic, but not written by writefileEncrypted()
+                        break;
+                    }
+                    slot_first = page;
+                    slot_end   = page + slot_pages;
+                    remaining  = record_len;
+                    offset     = 8;
+                    if (record_len == 0) {
+                        job->layout.freeSlots.insert(page, slot_pages);
+                        job->layout.freePages += slot_pages;
+                        continue;
+                    }
+                    digests = QByteArray();
+                    digests.reserve(slot_pages * PAGE_DIGEST_SIZE);
+                    n = job->reader.tasks.count();
+                }
+                if (job->layout.freeSlots.contains(slot_first)) continue;   // Rest of an unused slot
+
+                pageDigest(job->digestKey, data, digest);
+                digests.append((const char*) digest, PAGE_DIGEST_SIZE);
+                piece = qMin(CHUNK_PAGE_SIZE - offset, remaining);
+                if (!job->reader.feed(data + offset, piece)) job->status = 3;
+                remaining -= piece;
+                if (page == slot_end - 1) {
+                    // The slot must hold exactly one complete record:
+                    if (job->reader.pending() || job->reader.tasks.count() != n + 1) {
+                        job->status = 3;
+                        break;
+                    }
+                    if (job->layout.taskSlots.contains(job->reader.tasks.last().taskID)) job->layout.file = "";   // Slots are found by task ID - the next save rewrites the file
+                    job->layout.taskSlots.insert(job->reader.tasks.last().taskID, { slot_first, slot_end - slot_first, digests });
+                }
+            }
+            if (job->cancel.loadAcquire()) job->status = 2;
+            postProgress(job.data(), 90 + (int)(10ULL * (first + chunk_n) / page_count));
+        }
+
+        // The root tag covers the page count & save counter and the tags of all pages, so no page can be dropped or
+        // replaced by one of an older save. The decoded tasks are only used if it matches:
+        if (job->status == 0) {
+            opener.rootTag(meta, 16, (const uint8_t*) job->layout.tags.constData(), page_count, root);
+            if (!secure_compare(root, meta + 16, CHUNK_TAG_SIZE)) job->status = 4;
+            job->layout.rootTag = QByteArray((const char*) root, CHUNK_TAG_SIZE);
+        }
+    }
+    else if (job->file.version_no >= 102) {
+        // Chunked format: the nonce, followed by the chunks and their tags
+        if (readfile.read((char*) fileNonce, CHUNK_NONCE_SIZE) != CHUNK_NONCE_SIZE) {
+            job->status = 4;
+            return;
+        }
+        size_sealed = readfile.size() - 54 - CHUNK_NONCE_SIZE;
+        if (!ChunkCipher::openedSize(size_sealed, &size_plain)) {
+            job->status = 4;   // Truncated
+            return;
+        }
+        opener.setKey(job->key, 32);
+        opener.setNonce(fileNonce);
+        opener.setHeader(header, 54);
+        stride      = CHUNK_SIZE + CHUNK_TAG_SIZE;
+        chunk_count = ChunkCipher::chunkCount(size_plain);
+        window_size = qMin((quint32) (LOAD_WINDOW / stride), chunk_count) * stride;
+        window      = (uint8_t*) job->arena->alloc(window_size);
+        if (window == NULL) job->status = 3;
+
+        // Verify & decrypt a window of chunks in place (ChunkCipher spreads them across several threads), then decode the tasks:
+        for (first = 0; first < chunk_count && job->status == 0; first += chunk_n) {
+            chunk_n = qMin(chunk_count - first, (quint32) (window_size / stride));
+            n = qMin((qint64) (chunk_n * stride), (qint64) (size_sealed - first * stride));
+            if (readfile.read((char*) window, n) != n) {
+                job->status = 3;
+                break;
+            }
+            CTraceScope decrypt("decryptfile: openChunks");
+            if (!opener.openChunks(window, size_sealed, first, chunk_n)) {
+                job->status = 4;
+                break;
+            }
+            decrypt.end();
+            for (k = 0; k < chunk_n; k++) {
+                if (!job->reader.feed(window + k * stride, qMin((size_t) CHUNK_SIZE, size_plain - (size_t) (first + k) * CHUNK_SIZE))) {
+                    job->status = 3;
+                    break;
+                }
+            }
+            if (job->cancel.loadAcquire()) job->status = 2;
+            postProgress(job.data(), 90 + (int)(10ULL * (first + chunk_n) / chunk_count));
+        }
+    }
+    else {
+        size_cipher = readfile.size() - 54;  // File size minus magic no., version no., salt & hash
+        if (size_cipher < 32 || (size_cipher % 16) != 0) {
+            // writefileEncrypted() always wrote multiples of 16 Bytes, at least the leading block plus one
+            job->status = 3;
+            return;
+        }
+        window_size = qMin((qint64) LOAD_WINDOW, size_cipher);
+        window      = (uint8_t*) job->arena->alloc(window_size);
+        if (window == NULL) job->status = 3;
+
+        // Decrypt in place window by window - CBC carries the last ciphertext block over to the next window.
+        // The first block is unusable, the data is padded to the next multiple of 16 Bytes (with 1 to 16 Bytes):
+        decrypter.setKey(job->key, 32);
+        decrypter.setIV(job->key, 16);   // Actually we don't care about the IV on loading - the first block is discarded anyway
+        for (pos = 0; pos < size_cipher && job->status == 0; pos += n) {
+            n = qMin(size_cipher - pos, (qint64) window_size);
+            if (readfile.read((char*) window, n) != n) {
+                job->status = 3;
+                break;
+            }
+            CTraceScope decrypt("decryptfile: CBC decrypt");
+            decrypter.decrypt(window, window, n);
+            decrypt.end();
+            begin = qMax((qint64) 0, 16 - pos);
+            end   = n;
+            if (end > begin && !job->reader.feed(window + begin, end - begin)) job->status = 3;
+            if (job->cancel.loadAcquire()) job->status = 2;
+            postProgress(job.data(), 90 + (int)(10LL * (pos + n) / size_cipher));
+        }
+    }
+    readfile.close();
+
+    // Version 100/101: whatever is left of the last block after the last record is padding:
+    if (job->status == 0 && job->file.version_no < 102 && job->reader.carry.size() <= 16) {
+        clean(job->reader.carry.data(), job->reader.carry.size());
+        job->reader.carry.clear();
+    }
+
+    // A record cut off at the end of the data:
+    if (job->status == 0 && job->reader.pending()) job->status = 3;
+
+    job->arena->reset();
+}
+
+
+int CSaveFile::loadProgress(void *ctx, unsigned int done, unsigned int total)
+{
+// PBKDF2 progress callback (worker thread) - returns non-zero to abort the key derivation
+    sLoadJob *job = static_cast<sLoadJob*>(ctx);
+
+    postProgress(job, (int)(90ULL * done / total));
+
+    return job->cancel.loadAcquire();
+}
+
+
+void CSaveFile::postProgress(sLoadJob *job, int percent)
+{
+// Forward a progress report from the worker thread to the thread of the owner (only when the value changed)
+    quint32    generation;
+    CSaveFile *owner;
+
+    if (percent == job->lastProgress) return;
+    job->lastProgress = percent;
+
+    generation = job->generation;
+    owner      = job->owner;
+    QMetaObject::invokeMethod(owner, [owner, generation, percent]() { owner->setLoadProgress(generation, percent); }, Qt::QueuedConnection);
+}
+
+
+void CSaveFile::setLoadProgress(quint32 generation, int percent)
+{
+// Report the progress of the running job (thread of this object)
+    if (generation != loadGeneration || !decrypting) return;   // Report from an obsolete job
+
+    emit loadProgressChanged(percent);
+}
+
+
+void CSaveFile::finishLoad()
+{
+// Called on the thread of this object when the worker started by load_data() has finished
+    QSharedPointer<sLoadJob> job;
+    QString File;
+    int     i;
+    TRACE_SCOPE("CSaveFile::finishLoad");
+
+    job = loadJob;
+    if (job.isNull()) return;
+    File    = job->filename;
+    newFile = job->file;
+
+    if (job->status == 1) {
+        qWarning("Warning: Incorrect password!");
+        logger.warning() << "load_data(): Incorrect password provided!";
+    }
+    else if (job->status == 2) {
+        qInfo("load_data(): Loading cancelled.");
+        logger.info() << "load_data(): Loading cancelled: " << File;
+    }
+    else {
+        if (job->status == 0) {
+            // The tasks were decoded by the worker already - just put them in list order
+            // (version 103 files store them by slot, the saved row tells the position):
+            QVector<int> order(job->reader.tasks.count());
+            for (i=0; i<order.count(); i++) order[i] = i;
+            std::stable_sort(order.begin(), order.end(), [&job](int a, int b) { return job->reader.rows.at(a) < job->reader.rows.at(b); });
+            QList<Task> tasks;
+            tasks.reserve(order.count());
+            for (i=0; i<order.count(); i++) {
+                tasks.append(job->reader.tasks.at(order.at(i)));
+            }
+            emit tasksAboutToBeReplaced();
+            close();
+            store.setTasks(tasks);
+            emit tasksReplaced();
+        }
+        if (job->status == 4) {
+            qWarning("Encrypted save file %s is damaged or was modified!",File.toUtf8().data());
+            logger.warning() << "load_data(): Authentication failed - encrypted save file damaged or modified: " << File;
+            newFile.SaveFileName     = "";
+            newFile.SaveFileNameFull = "";
+        }
+        else if (job->status != 0) {
+            qWarning("Could not read encrypted save file %s!",File.toUtf8().data());
+            logger.warning() << "load_data(): Could not read encrypted save file: " << File;
+            newFile.SaveFileName     = "";
+            newFile.SaveFileNameFull = "";
+        }
+        else {
+            // Update the active file only when everything went OK
+            activeFile       = newFile;
+            // The key stays valid for saving as long as password & salt don't change:
+            memcpy(&key[0], &(job->key[0]), 32);
+            chunks.setKey(key, 32);
+            keyCached = 1;
+            // Page layout for incremental saving (version 103 only, the job gets the old one for wiping):
+            invalidateLayout();
+            std::swap(layout, job->layout);
+        }
+    }
+
+    newFile.Password = "";
+
+    decrypting = false;
+    emit loaded(job->status);
+
+    // Wipes key & decrypted data:
+    loadJob.clear();
+}
+
+
+int CSaveFile::save_data(const QString &File)
+{
+// The routine to save data to a file.
+// Also makes File the active file (an empty name only updates the active file)
+    int ret;
+    TRACE_SCOPE("CSaveFile::save_data");
+
+    // Update the filename of the active file:
+    activeFile.SaveFileNameFull = File;
+    activeFile.SaveFileName     = File.section("/",-1);
+
+    if (!activeFile.SaveFileNameFull.isEmpty()) {
+        if (activeFile.encrypted) {
+            ret = writefileEncrypted();
+        }
+        else {
+            ret = writefile();
+        }
+        if (ret != 0) return ret;
+    }
+    else {
+        qInfo("save_data(): SaveFileNameFull empty - no save file written!");
+        logger.info() << "save_data(): SaveFileNameFull empty - no save file written!";
+    }
+
+    return 0;
+}
+
+
+void CSaveFile::set_password(const QString &PW)
+{
+// Set the password for the active file
+// If the file was previously unencrypted, it will be saved in encrypted format immediately
+// If the file was already encrypted, it will be re-encrypted with the new password (even if the password is the same, since a new salt is generated)
+    quint32  random_number;
+    int      i;
+
+    activeFile.encrypted  = 1;
+    activeFile.Password   = PW;
+    activeFile.version_no = 103;   // New passwords always use the current key derivation & file format
+    invalidateKeyCache();
+    // Generate a new salt for this password:
+    for (i=0; i<16; i+=4) {
+        random_number = QRandomGenerator::global()->generate();
+        memcpy(&(activeFile.salt[i]), &random_number, 4);
+    }
+
+    logger.info() << "set_password(): Password changed.";
+
+    // Save the file
+    if (!activeFile.SaveFileNameFull.isEmpty()) {
+        writefileEncrypted();
+    }
+    else {
+        qInfo("set_password(): SaveFileNameFull empty - no save file written!");
+        logger.info() << "set_password(): SaveFileNameFull empty - no save file written!";
+    }
+
+}
+
+
+void CSaveFile::removeEncryption()
+{
+// Remove encryption from the active file
+    uint8_t old_format;
+
+    old_format = activeFile.encrypted;
+
+    activeFile.encrypted  = 0;
+    invalidateKeyCache();
+
+    // Save the file if the format was changed:
+    if (activeFile.encrypted != old_format) {
+        if (!activeFile.SaveFileNameFull.isEmpty()) {
+            writefile();
+        }
+        else {
+            qInfo("removeEncryption(): SaveFileNameFull empty - no save file written!");
+            logger.info() << "removeEncryption(): SaveFileNameFull empty - no save file written!";
+        }
+    }
+    else {
+        //qInfo("File already unencrypted - no save file written!");
+    }
+
+}
+
+
+void CSaveFile::close()
+{
+// Forget the active file when the tasks are removed (leaves the store alone)
+    TRACE_SCOPE("CSaveFile::close");
+
+    // Reset filename to prevent overwriting the original file:
+    activeFile.SaveFileName     = "";
+    activeFile.SaveFileNameFull = "";
+    activeFile.magic_no         = 0;
+    activeFile.version_no       = 0;
+    // Reset password:
+    activeFile.encrypted        = 0;
+    activeFile.Password         = "";
+    memset(activeFile.PasswordHashRead, 0, 32);
+    memset(activeFile.salt, 0, 16);
+    invalidateKeyCache();
+}
+
+
+void CSaveFile::invalidateKeyCache()
+{
+// Wipe the cached encryption key and key schedule - the next encrypted save derives the key again
+    keyCached = 0;
+    chunks.clear();
+    clean(key, 32);
+    invalidateLayout();
+}
+
+
+int CSaveFile::deriveKey(const QString &Password, const uint8_t *Salt, quint16 Version, uint8_t *Key, pbkdf2_progress_cb progress, void *ctx)
+{
+// Derive the encryption key from password & salt, using the PBKDF2 variant of the given save file version
+// Thread-safe; returns 0 on success, -2 if aborted by the progress callback
+    int     len, ret;
+    uint8_t pass[32];   // On the stack - no heap copy of the password is left behind
+    TRACE_SCOPE("CSaveFile::deriveKey");
+
+    len = 32;
+    if (Password.length()<32) len = Password.length();   // Use only the first 32 Bytes
+
+    memset(pass, 0, sizeof(pass));
+    memcpy(pass, Password.toUtf8().data(), len);
+
+    if (Version >= 101) {
+        ret = pkcs5_pbkdf2_sha256(pass, len, Salt, 16, Key, 32, 10000, progress, ctx);
+    }
+    else {
+        ret = pkcs5_pbkdf2(pass, len, Salt, 16, Key, 32, 4096, progress, ctx);
+    }
+
+    clean(pass, sizeof(pass));
+
+    return ret;
+}
+
+
+QString CSaveFile::csvWriter()
+{
+//  Export time data to CSV format, next to the active file
+    QFile csvfile;
+    QString exportfilename;
+    TRACE_SCOPE("CSaveFile::csvWriter");
+
+    if (!activeFile.SaveFileNameFull.isEmpty()) {
+        // Use as base name the active filename up to the last dot:
+        exportfilename = activeFile.SaveFileNameFull.section(".",0,-2);
+    }
+    else {
+        // If no filename has been specified yet, use generic name:
+        exportfilename = "export";
+    }
+    // Add a date/timestamp to the filename:
+    exportfilename.append("-");
+    exportfilename.append(QDate::currentDate().toString("yyyy-MM-dd").toUtf8().data());
+    exportfilename.append("-");
+    exportfilename.append(QTime::currentTime().toString("HHmmss").toUtf8().data());
+    exportfilename.append(".csv");
+    csvfile.setFileName(exportfilename);
+
+    qInfo("Writing CSV file...");
+    logger.info() << "Writing CSV file...";
+
+    if (!csvfile.open(QIODevice::WriteOnly)) {
+        qWarning("Could not open CSV file: %s",exportfilename.toUtf8().data());
+        logger.warning() << "Could not open CSV file: " << exportfilename;
+        return "";
+    }
+    QTextStream out(&csvfile);
+    out.setCodec("UTF-8");
+    store.writeCsv(out);
+
+    csvfile.close();
+
+    return exportfilename.section("/",-1);
+}
+
+
+bool CSaveFile::readfile(QString filename, QList<Task> &tasks)
+{
+//  Read data from unencrypted saved file into the tasks list
+//  ToDo: Sanity check of file
+    int i, n, row, n_days, flag;
+    quint8  dummy;
+    quint32 dummy32;
+    quint32 magic_no;
+    quint16 version_no;
+    quint8  thisMonth, thisMonthSaved;
+    quint16 thisYear, thisYearSaved;
+    QDate   today;
+    Task t;
+    qint64 day, daySaved;
+    QDate Date;
+    sTime Time;
+    QMap<QDate, sTime> log;
+    QFile readfile;
+    TRACE_SCOPE("CSaveFile::readfile");
+
+    qInfo("Reading unencrypted save file: %s",filename.toUtf8().data());
+    logger.info() << "readfile(): Reading unencrypted save file: " << filename;
+
+    // Times saved before the date of the store are reset:
+    today     = store.today();
+    thisMonth = store.thisMonth();
+    thisYear  = store.thisYear();
+
+    readfile.setFileName(filename);
+
+    if (!readfile.open(QIODevice::ReadOnly)) {
+        qWarning("Could not read save file - %s!",filename.toUtf8().data());
+        logger.warning() << "readfile(): Could not read save file: " << filename;
+        return false;
+    };
+    QDataStream in(&readfile);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    // Magic number
+    in >> magic_no;       //qInfo("Magic no. = %X",magic_no);
+    if (magic_no != 0x051076A0) {
+        qWarning("Bad save file format - %s!",filename.toUtf8().data());
+        logger.warning() << "readfile(): Bad save file format: " << filename;
+        return false;
+    }
+    // Version number
+    in >> version_no;       //qInfo("Version no. = %d",version_no);
+    if (version_no != 100) {
+        qWarning("Bad save file version - %s!",filename.toUtf8().data());
+        logger.warning() << "readfile(): Bad save file version: " << filename;
+        return false;
+    }
+
+    // 16 Byte Salt & 32 Byte hashed encryption key (dummy entries)
+    for (i=0; i<16; i++) {
+        in >> dummy;
+    }
+    for (i=0; i<32; i++) {
+        in >> dummy;
+    }
+
+    while(!in.atEnd()) {
+        in >> row;                  //qInfo("row: %d",row);
+        in >> t.title;              //qInfo("title: %s",t.title.toUtf8().data());
+        in >> t.description;        //qInfo("description: %s",t.description.toUtf8().data());
+        in >> t.taskID;             //qInfo("taskID: %u",t.taskID);
+              t.taskActive   = 0;
+              t.allocateTime = 0;
+        // timeTotal
+        in >> t.timeTotal.Hours;
+        in >> t.timeTotal.Minutes;
+        in >> t.timeTotal.Seconds;
+        in >> t.timeTotal.elapsedSeconds;
+        // timeToday
+        in >> daySaved;
+        in >> t.timeToday.Hours;
+        in >> t.timeToday.Minutes;
+        in >> t.timeToday.Seconds;
+        in >> t.timeToday.elapsedSeconds;
+        if (daySaved != today.toJulianDay()) {
+            // If timeToday was saved on another day, reset it:
+            t.timeToday.Hours   = 0;
+            t.timeToday.Minutes = 0;
+            t.timeToday.Seconds = 0;
+            t.timeToday.elapsedSeconds = 0;
+        }
+        t.timeTodayString = QString("%1:%2:%3").arg(t.timeToday.Hours,2,10,QLatin1Char('0')).arg(t.timeToday.Minutes,2,10,QLatin1Char('0')).arg(t.timeToday.Seconds,2,10,QLatin1Char('0'));  //qInfo("timeTodayString: %s\n",t.timeTodayString.toUtf8().data());
+        // timeThisMonth
+        in >> thisMonthSaved;
+        in >> t.timeThisMonth.Hours;
+        in >> t.timeThisMonth.Minutes;
+        in >> t.timeThisMonth.Seconds;
+        in >> t.timeThisMonth.elapsedSeconds;
+        if (thisMonthSaved != thisMonth) {
+            // If timeThisMonth was saved in another month, reset it:
+            t.timeThisMonth.Hours   = 0;
+            t.timeThisMonth.Minutes = 0;
+            t.timeThisMonth.Seconds = 0;
+            t.timeThisMonth.elapsedSeconds = 0;
+        }
+        t.timeThisMonthString = QString("%1:%2:%3").arg(t.timeThisMonth.Hours,2,10,QLatin1Char('0')).arg(t.timeThisMonth.Minutes,2,10,QLatin1Char('0')).arg(t.timeThisMonth.Seconds,2,10,QLatin1Char('0'));  //qInfo("timeThisMonth: %s\n",t.timeThisMonthString.toUtf8().data());
+        // timeThisYear
+        in >> thisYearSaved;          //qInfo("thisYearSaved: %d",thisYearSaved);
+        in >> t.timeThisYear.Hours;
+        in >> t.timeThisYear.Minutes;
+        in >> t.timeThisYear.Seconds;
+        in >> t.timeThisYear.elapsedSeconds;
+        if (thisYearSaved != thisYear) {
+            // If timeThisYear was saved in another year, reset it:
+            t.timeThisYear.Hours   = 0;
+            t.timeThisYear.Minutes = 0;
+            t.timeThisYear.Seconds = 0;
+            t.timeThisYear.elapsedSeconds = 0;
+        }
+        t.timeThisYearString = QString("%1:%2:%3").arg(t.timeThisYear.Hours,2,10,QLatin1Char('0')).arg(t.timeThisYear.Minutes,2,10,QLatin1Char('0')).arg(t.timeThisYear.Seconds,2,10,QLatin1Char('0'));  //qInfo("timeThisMonth: %s\n",t.timeThisYearString.toUtf8().data());
+        // timeDaily
+        in >> t.timeDaily.Hours;
+        in >> t.timeDaily.Minutes;
+        in >> t.timeDaily.Seconds;
+        in >> t.timeDaily.elapsedSeconds;
+        // timeMonthly
+        in >> t.timeMonthly.Hours;
+        in >> t.timeMonthly.Minutes;
+        in >> t.timeMonthly.Seconds;
+        in >> t.timeMonthly.elapsedSeconds;
+        // timeYearly
+        in >> t.timeYearly.Hours;
+        in >> t.timeYearly.Minutes;
+        in >> t.timeYearly.Seconds;
+        in >> t.timeYearly.elapsedSeconds;
+        // timelog
+        flag = 0;
+        in >> n_days;              //printf("n_days: %d\n",n_days);
+        for (n=0; n<n_days; n++) {
+            in >> day;   // Julian day
+            Date = QDate::fromJulianDay(day);        //printf("Date: %s\n",Date.toString().toUtf8().data());
+            in >> Time.Hours;
+            in >> Time.Minutes;
+            in >> Time.Seconds;
+            in >> Time.elapsedSeconds;               //printf("elapsedSeconds: %d\n",Time.elapsedSeconds);
+            log.insert(Date, Time);
+            if (Date == today) flag = 1;   // Flag if we already have an entry for today, otherwise we need to create it
+        }
+        if (flag == 0) {
+            // Insert an empty entry for today if it does not exist yet
+            Time.Hours          = 0;
+            Time.Minutes        = 0;
+            Time.Seconds        = 0;
+            Time.elapsedSeconds = 0;
+            log.insert(today, Time);
+        }
+        t.timelog = log;
+        tasks.append(t);
+        in >> dummy32;
+        log.clear();
+    }
+
+    readfile.close();
+
+    return true;
+}
+
+
+
+int CSaveFile::recordSize(const uint8_t *record, size_t avail)
+{
+//  Size of a task record (see serializeTask()): 257 Bytes + 18 Bytes per day of the timelog
+//  With less than the fixed part available, the fixed part is needed first. Returns -1 for an impossible no. of days.
+    qint32 n_days;
+
+    if (avail < 253) return 253;
+    memcpy(&n_days, &record[249], 4);
+    if (n_days < 0 || n_days > 0x100000) return -1;
+
+    return 257 + n_days * 18;
+}
+
+
+CSaveFile::sRecordReader::sRecordReader()
+{
+    thisMonth = 0;
+    thisYear  = 0;
+}
+
+
+CSaveFile::sRecordReader::~sRecordReader()
+{
+    if (!carry.isEmpty()) clean(carry.data(), carry.size());
+}
+
+
+bool CSaveFile::sRecordReader::feed(const uint8_t *data, size_t len)
+{
+//  Decode the task records in a piece of decrypted data (thread-safe, used by decryptfile())
+//  Records completely within the piece are decoded in place; only a record crossing into the next piece is copied.
+//  Returns false if the data can't be task records.
+    int    size;
+    size_t take;
+
+    // Complete the record started in the previous piece:
+    while (!carry.isEmpty()) {
+        size = recordSize((const uint8_t*) carry.constData(), carry.size());
+        if (size < 0) return false;
+        if (carry.size() >= size) {
+            decode((const uint8_t*) carry.constData());
+            clean(carry.data(), carry.size());
+            carry.clear();
+            break;
+        }
+        take = qMin((size_t) (size - carry.size()), len);
+        if (take == 0) return true;
+        carry.append((const char*) data, take);
+        data += take;
+        len  -= take;
+    }
+
+    while (len > 0) {
+        size = recordSize(data, len);
+        if (size < 0) return false;
+        if ((size_t) size > len) {
+            carry.append((const char*) data, len);
+            break;
+        }
+        decode(data);
+        data += size;
+        len  -= size;
+    }
+
+    return true;
+}
+
+
+void CSaveFile::sRecordReader::decode(const uint8_t *record)
+{
+//  Decode one complete task record into tasks
+    int n, n_days, flag;
+    int idx;
+    qint32 row;
+    quint8  monthSaved;
+    quint16 yearSaved;
+    Task t;
+    qint64 day, daySaved;
+    QDate Date;
+    sTime Time;
+
+    idx = 0;
+    memcpy(&row, &record[idx],4);  idx += 4;                       //qInfo("row: %d",row);
+    t.title = QString::fromUtf8((const char*) &record[idx], qstrnlen((const char*) &record[idx], 32));  idx += 32;                 //qInfo("title: %s",t.title.toUtf8().data());
+    t.description = QString::fromUtf8((const char*) &record[idx], qstrnlen((const char*) &record[idx], 128));  idx += 128;   //qInfo("description: %s",t.description.toUtf8().data());
+
+    memcpy(&(t.taskID), &record[idx],4);  idx += 4;               //qInfo("taskID: %d",t.taskID);
+    t.taskActive   = 0;
+    t.allocateTime = 0;
+    // timeTotal
+    memcpy(&(t.timeTotal.Hours), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeTotal.Minutes), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeTotal.Seconds), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeTotal.elapsedSeconds), &record[idx],4);  idx += 4;
+    // timeToday
+    memcpy(&daySaved, &record[idx],8);  idx += 8;
+    memcpy(&(t.timeToday.Hours), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeToday.Minutes), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeToday.Seconds), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeToday.elapsedSeconds), &record[idx],4);  idx += 4;
+    if (daySaved != today.toJulianDay()) {
+        // If timeToday was saved on another day, reset it:
+        t.timeToday.Hours   = 0;
+        t.timeToday.Minutes = 0;
+        t.timeToday.Seconds = 0;
+        t.timeToday.elapsedSeconds = 0;
+    }
+    t.timeTodayString = QString("%1:%2:%3").arg(t.timeToday.Hours,2,10,QLatin1Char('0')).arg(t.timeToday.Minutes,2,10,QLatin1Char('0')).arg(t.timeToday.Seconds,2,10,QLatin1Char('0'));  //qInfo("timeTodayString: %s\n",t.timeTodayString.toUtf8().data());
+    // timeThisMonth
+    memcpy(&monthSaved, &record[idx],1);  idx += 1;
+    memcpy(&(t.timeThisMonth.Hours), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeThisMonth.Minutes), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeThisMonth.Seconds), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeThisMonth.elapsedSeconds), &record[idx],4);  idx += 4;
+    if (monthSaved != thisMonth) {
+        // If timeThisMonth was saved in another month, reset it:
+        t.timeThisMonth.Hours   = 0;
+        t.timeThisMonth.Minutes = 0;
+        t.timeThisMonth.Seconds = 0;
+        t.timeThisMonth.elapsedSeconds = 0;
+    }
+    t.timeThisMonthString = QString("%1:%2:%3").arg(t.timeThisMonth.Hours,2,10,QLatin1Char('0')).arg(t.timeThisMonth.Minutes,2,10,QLatin1Char('0')).arg(t.timeThisMonth.Seconds,2,10,QLatin1Char('0'));  //qInfo("timeThisMonth: %s\n",t.timeThisMonthString.toUtf8().data());
+    // timeThisYear
+    memcpy(&yearSaved, &record[idx],2);  idx += 2;
+    memcpy(&(t.timeThisYear.Hours), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeThisYear.Minutes), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeThisYear.Seconds), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeThisYear.elapsedSeconds), &record[idx],4);  idx += 4;
+    if (yearSaved != thisYear) {
+        // If timeThisYear was saved in another year, reset it:
+        t.timeThisYear.Hours   = 0;
+        t.timeThisYear.Minutes = 0;
+        t.timeThisYear.Seconds = 0;
+        t.timeThisYear.elapsedSeconds = 0;
+    }
+    t.timeThisYearString = QString("%1:%2:%3").arg(t.timeThisYear.Hours,2,10,QLatin1Char('0')).arg(t.timeThisYear.Minutes,2,10,QLatin1Char('0')).arg(t.timeThisYear.Seconds,2,10,QLatin1Char('0'));  //qInfo("timeThisYear: %s\n",t.timeThisYearString.toUtf8().data());
+    // timeDaily
+    memcpy(&(t.timeDaily.Hours), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeDaily.Minutes), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeDaily.Seconds), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeDaily.elapsedSeconds), &record[idx],4);  idx += 4;
+    // timeMonthly
+    memcpy(&(t.timeMonthly.Hours), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeMonthly.Minutes), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeMonthly.Seconds), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeMonthly.elapsedSeconds), &record[idx],4);  idx += 4;
+    // timeYearly
+    memcpy(&(t.timeYearly.Hours), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeYearly.Minutes), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeYearly.Seconds), &record[idx],2);  idx += 2;
+    memcpy(&(t.timeYearly.elapsedSeconds), &record[idx],4);  idx += 4;
+    // timelog
+    flag = 0;
+    memcpy(&n_days, &record[idx],4);  idx += 4;                   //printf("n_days: %d\n",n_days);
+    for (n=0; n<n_days; n++) {
+        memcpy(&day, &record[idx],8);  idx += 8;   // Julian day
+        Date = QDate::fromJulianDay(day);        //printf("Date: %s\n",Date.toString().toUtf8().data());
+        memcpy(&(Time.Hours),   &record[idx],2);  idx += 2;
+        memcpy(&(Time.Minutes), &record[idx],2);  idx += 2;
+        memcpy(&(Time.Seconds), &record[idx],2);  idx += 2;
+        memcpy(&(Time.elapsedSeconds), &record[idx],4);  idx += 4;               //printf("elapsedSeconds: %d\n",Time.elapsedSeconds);
+        t.timelog.insert(t.timelog.constEnd(), Date, Time);   // Saved in ascending order
+        if (Date == today) flag = 1;   // Flag if we already have an entry for today, otherwise we need to create it
+    }
+    if (flag == 0) {
+        // Insert an empty entry for today if it does not exist yet
+        Time.Hours          = 0;
+        Time.Minutes        = 0;
+        Time.Seconds        = 0;
+        Time.elapsedSeconds = 0;
+        t.timelog.insert(today, Time);
+    }
+    // Last 4 Bytes unused (formerly nextID)
+
+    tasks.append(t);
+    rows.append(row);
+}
+
+
+int CSaveFile::writefile()
+{
+//  Write all necessary data to file in plaintext format
+    int i, n;
+    Task task;
+    QFile savefiledat;
+    QMap<QDate, sTime>::const_iterator it;
+    TRACE_SCOPE("CSaveFile::writefile");
+
+    qInfo("writefile(): Writing unencrypted save file: %s",activeFile.SaveFileNameFull.toUtf8().data());
+    logger.info() << "writefile(): Writing unencrypted save file: " << activeFile.SaveFileNameFull;
+
+    savefiledat.setFileName(activeFile.SaveFileNameFull);
+
+
+    if (!savefiledat.open(QIODevice::WriteOnly)) {
+        qWarning("writefile(): Could not open save file: %s",activeFile.SaveFileNameFull.toUtf8().data());
+        logger.warning() << "writefile(): Could not open save file: " << activeFile.SaveFileNameFull;
+        return 1;
+    }
+    QDataStream out(&savefiledat);
+    out.setVersion(QDataStream::Qt_5_0);
+
+
+    // Magic number to verify file format
+    out << (quint32)0x051076A0;
+    // Version number
+    out << (quint16) 100;
+
+    // 16 Byte Salt & 32 Byte hashed encryption key (not used)
+    for (i=0; i<16; i++) {
+        out << (quint8) i;
+    }
+    for (i=0; i<32; i++) {
+        out << (quint8) i;
+    }
+
+    for(i=0; i<store.count(); i++) {
+        task = store.task(i);
+        out << (qint32) i;
+        out << (QString) task.title;
+        out << (QString) task.description;
+        out << (quint32) task.taskID;
+        // taskActive is not saved
+        // allocateTime is not saved
+        // timeTotal
+        out << (quint16) task.timeTotal.Hours;
+        out << (quint16) task.timeTotal.Minutes;
+        out << (quint16) task.timeTotal.Seconds;
+        out << (quint32) task.timeTotal.elapsedSeconds;
+        // timeToday
+        out << (qint64)  store.today().toJulianDay();
+        out << (quint16) task.timeToday.Hours;
+        out << (quint16) task.timeToday.Minutes;
+        out << (quint16) task.timeToday.Seconds;
+        out << (quint32) task.timeToday.elapsedSeconds;
+        // timeThisMonth
+        out << (quint8)  store.thisMonth();
+        out << (quint16) task.timeThisMonth.Hours;
+        out << (quint16) task.timeThisMonth.Minutes;
+        out << (quint16) task.timeThisMonth.Seconds;
+        out << (quint32) task.timeThisMonth.elapsedSeconds;
+        // timeThisYear
+        out << (quint16) store.thisYear();
+        out << (quint16) task.timeThisYear.Hours;
+        out << (quint16) task.timeThisYear.Minutes;
+        out << (quint16) task.timeThisYear.Seconds;
+        out << (quint32) task.timeThisYear.elapsedSeconds;
+        // timeDaily
+        out << (quint16) task.timeDaily.Hours;
+        out << (quint16) task.timeDaily.Minutes;
+        out << (quint16) task.timeDaily.Seconds;
+        out << (quint32) task.timeDaily.elapsedSeconds;
+        // timeMonthly
+        out << (quint16) task.timeMonthly.Hours;
+        out << (quint16) task.timeMonthly.Minutes;
+        out << (quint16) task.timeMonthly.Seconds;
+        out << (quint32) task.timeMonthly.elapsedSeconds;
+        // timeYearly
+        out << (quint16) task.timeYearly.Hours;
+        out << (quint16) task.timeYearly.Minutes;
+        out << (quint16) task.timeYearly.Seconds;
+        out << (quint32) task.timeYearly.elapsedSeconds;
+       // timelog
+        out << (qint32) task.timelog.size();         //printf("Writing timelog.size(): %d\n",task.timelog.size());
+        it = task.timelog.constBegin();
+        for (n = 0; n < task.timelog.size(); n++) {
+            out << (qint64)  it.key().toJulianDay();
+            out << (quint16) it.value().Hours;
+            out << (quint16) it.value().Minutes;
+            out << (quint16) it.value().Seconds;
+            out << (quint32) it.value().elapsedSeconds;
+            it++;
+        }
+        //
+        out << (quint32) 0;             //Unused (formerly nextID)
+    }
+
+
+    savefiledat.close();
+
+    return 0;
+}
+
+
+int CSaveFile::writefileEncrypted()
+{
+//  Write all necessary data to an encrypted file
+//
+//  The magic no. (file format) and version no. are saved unencrypted,
+//  to allow distinguishing between an encrypted and unencrypted file on startup.
+//  All task- and time-related data is encrypted.
+//  Encryption uses AES256 in CTR mode, in pages of 1 kB authenticated with HMAC-SHA256 (see ChunkCipher).
+//  File layout (version 103): magic no., version no., salt, password hash, page count, page size, save counter, root tag, pages.
+//  Every task is stored in a slot of consecutive pages (with some room to grow). Slots are only rewritten where they changed
+//  since the last save, so saving after a change to one task costs the same regardless of the number of tasks.
+//  The whole file is only written for a new file, a new password or when too many pages are unused.
+    int i, len;
+    int ret;
+    bool unique;
+    QByteArray header;
+    QVector<QByteArray> records;
+    QSet<quint32> taskIDs;
+    TRACE_SCOPE("CSaveFile::writefileEncrypted");
+
+    qInfo("Writing encrypted save file: %s",activeFile.SaveFileNameFull.toUtf8().data());
+    logger.info() << "writefileEncrypted(): Writing encrypted save file: " << activeFile.SaveFileNameFull;
+
+//    if (activeFile.Password.isEmpty()) {
+//        qInfo("Warning: Password is empty!");
+//    }
+
+    len = 32;
+    if (activeFile.Password.length()<32) len = activeFile.Password.length();
+
+    // Files of older versions are converted to the current format (and key derivation) on saving:
+    if (activeFile.version_no < 103) {
+        activeFile.version_no = 103;
+        invalidateKeyCache();
+    }
+
+    // Set the encryption key - only derived if password or salt changed since the last load/save:
+    if (!keyCached) {
+        memset(&key[0], 0, 32);
+        deriveKey(activeFile.Password, activeFile.salt, activeFile.version_no, &key[0]);
+        chunks.setKey(key, 32);
+        keyCached = 1;
+    }
+    //qInfo("salt = %02x%02x%02x%02x%02x%02x%02x%02x",activeFile.salt[0],activeFile.salt[1],activeFile.salt[2],activeFile.salt[3],activeFile.salt[4],activeFile.salt[5],activeFile.salt[6],activeFile.salt[7]);
+    //qInfo("key = %s",key);
+
+    // Hash the password (unsalted) for storage:
+    sha256.clear();
+    sha256.update(activeFile.Password.toUtf8().data(), len);
+    sha256.finalize(&PasswordHash[0], 32);
+    //qInfo("PasswordHash:  %02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x",
+    //      PasswordHash[0],PasswordHash[1],PasswordHash[2],PasswordHash[3],PasswordHash[4],PasswordHash[5],PasswordHash[6],PasswordHash[7],PasswordHash[8],PasswordHash[9],PasswordHash[10],PasswordHash[11],PasswordHash[12],PasswordHash[13],PasswordHash[14],PasswordHash[15]);
+
+    // Magic no., version no., salt & password hash are written unencrypted (but authenticated):
+    QDataStream out(&header, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    // Magic number to verify file format
+    out << (quint32)0x051076B0;
+    // Version number
+    out << (quint16) activeFile.version_no;
+    // 16 Byte Salt & 32 Byte hashed password
+    for (i=0; i<16; i++) {
+        out << (quint8) activeFile.salt[i];
+    }
+    for (i=0; i<32; i++) {
+        out << (quint8) PasswordHash[i];
+    }
+    chunks.setHeader((const uint8_t*) header.constData(), header.size());
+
+    unique = true;
+    // Serialize all tasks (cheap compared to encrypting & writing - the result tells which slots changed):
+    records.reserve(store.count());
+    for (i=0; i<store.count(); i++) {
+        records.append(serializeTask(i, saveArena));
+        if (taskIDs.contains(store.taskID(i))) unique = false;
+        taskIDs.insert(store.taskID(i));
+    }
+
+    // Slots are found by task ID, so duplicate IDs need a full write as well:
+    if (layout.file != activeFile.SaveFileNameFull || layout.freePages > layout.pageCount / 2 || !unique) {
+        ret = writePagedFull(header, records);
+    }
+    else {
+        ret = writePagedIncremental(records);
+    }
+
+    // Wipe the task records & pages (the memory stays with the arena for the next save):
+    records.clear();
+    saveArena.reset();
+
+    return ret;
+}
+
+
+QByteArray CSaveFile::serializeTask(int i, SecureArena &arena)
+{
+//  Task record as saved in encrypted files (97 Bytes time data, title, description, 18 Bytes per day of the timelog)
+//  The record lives in the arena (zero-filled, so an unchanged task always gives the same bytes) until its next reset().
+    int n, idx, size;
+    qint32 timelog_size;
+    qint64 JulianDay;
+    quint8  thisMonth;
+    quint16 thisYear;
+    QMap<QDate, sTime>::const_iterator it;
+    uint8_t *record;
+    QByteArray utf8;
+    const Task task = store.task(i);
+
+    size   = 97 + 32 + 128 + task.timelog.size() * 18;
+    record = (uint8_t*) arena.alloc(size);
+    if (record == NULL) return QByteArray(size, 0);   // Out of memory - saving fails on the buffer for the pages
+
+    idx = 0;
+    memcpy(&record[idx], &i, 4);  idx += 4;
+    memset(&record[idx], 0, 32);
+    utf8 = task.title.toUtf8();
+    memcpy(&record[idx], utf8.constData(), qMin(utf8.size(), 32));  // Max. 32 bytes (UTF-8, not characters)
+    idx += 32;
+    memset(&record[idx], 0, 128);
+    utf8 = task.description.toUtf8();
+    memcpy(&record[idx], utf8.constData(), qMin(utf8.size(), 128));  // Max. 128 bytes
+    idx += 128;
+    clean(utf8.data(), utf8.size());
+    memcpy(&record[idx], &(task.taskID), 4);  idx += 4;
+    // taskActive is not saved
+    // allocateTime is not saved
+    // timeTotal
+    memcpy(&record[idx], &(task.timeTotal.Hours), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeTotal.Minutes), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeTotal.Seconds), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeTotal.elapsedSeconds), 4);  idx += 4;
+    // timeToday
+    JulianDay = store.today().toJulianDay();
+    memcpy(&record[idx], &JulianDay, 8);  idx += 8;
+    memcpy(&record[idx], &(task.timeToday.Hours), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeToday.Minutes), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeToday.Seconds), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeToday.elapsedSeconds), 4);  idx += 4;
+    // timeThisMonth
+    thisMonth = store.thisMonth();
+    memcpy(&record[idx], &thisMonth, 1);  idx += 1;
+    memcpy(&record[idx], &(task.timeThisMonth.Hours), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeThisMonth.Minutes), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeThisMonth.Seconds), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeThisMonth.elapsedSeconds), 2);  idx += 4;
+    // timeThisYear
+    thisYear = store.thisYear();
+    memcpy(&record[idx], &thisYear, 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeThisYear.Hours), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeThisYear.Minutes), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeThisYear.Seconds), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeThisYear.elapsedSeconds), 4);  idx += 4;
+    // timeDaily
+    memcpy(&record[idx], &(task.timeDaily.Hours), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeDaily.Minutes), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeDaily.Seconds), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeDaily.elapsedSeconds), 2);  idx += 4;
+    // timeMonthly
+    memcpy(&record[idx], &(task.timeMonthly.Hours), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeMonthly.Minutes), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeMonthly.Seconds), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeMonthly.elapsedSeconds), 2);  idx += 4;
+    // timeYearly
+    memcpy(&record[idx], &(task.timeYearly.Hours), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeYearly.Minutes), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeYearly.Seconds), 2);  idx += 2;
+    memcpy(&record[idx], &(task.timeYearly.elapsedSeconds), 2);  idx += 4;
+    // timelog
+    timelog_size = task.timelog.size();
+    memcpy(&record[idx], &timelog_size, 4);  idx += 4;         //printf("Writing timelog.size(): %d\n",task.timelog.size());
+    it = task.timelog.constBegin();
+    for (n = 0; n < task.timelog.size(); n++) {
+        JulianDay = it.key().toJulianDay();
+        memcpy(&record[idx], &JulianDay, 8);  idx += 8;
+        memcpy(&record[idx], &(it.value().Hours), 2);  idx += 2;
+        memcpy(&record[idx], &(it.value().Minutes), 2);  idx += 2;
+        memcpy(&record[idx], &(it.value().Seconds), 2);  idx += 2;
+        memcpy(&record[idx], &(it.value().elapsedSeconds), 4);  idx += 4;
+        it++;
+    }
+    // nextID
+    memset(&record[idx], 0, 4);   idx += 4;            //Unused (formerly nextID)
+
+    return QByteArray::fromRawData((const char*) record, size);
+}
+
+
+void CSaveFile::slotPage(quint32 pages, const QByteArray &record, quint32 k, uint8_t *page)
+{
+//  Plaintext of page k of a slot: the slot holds the no. of pages & record length (0: unused slot), the task record
+//  and zeros up to the end of its last page. Written straight into the page buffer, so the slot is never copied as a whole.
+    quint32 size, begin, end;
+
+    memset(page, 0, CHUNK_PAGE_SIZE);
+    size = record.size();
+    if (k == 0) {
+        memcpy(page, &pages, 4);
+        memcpy(page + 4, &size, 4);
+    }
+    // Part of the record on this page (the record starts at Byte 8 of the slot):
+    begin = qMax(k * CHUNK_PAGE_SIZE, (quint32) 8);
+    end   = qMin((k + 1) * CHUNK_PAGE_SIZE, 8 + size);
+    if (end > begin) memcpy(page + begin - k * CHUNK_PAGE_SIZE, record.constData() + begin - 8, end - begin);
+}
+
+
+QByteArray CSaveFile::pageMeta()
+{
+//  File information following the header: page count, page size & save counter (big endian, as QDataStream writes it)
+    QByteArray meta;
+    QDataStream out(&meta, QIODevice::WriteOnly);
+
+    out.setVersion(QDataStream::Qt_5_0);
+    out << (quint32) layout.pageCount;
+    out << (quint32) CHUNK_PAGE_SIZE;
+    out << (quint64) layout.saveCounter;
+
+    return meta;
+}
+
+
+int CSaveFile::writePagedFull(const QByteArray &header, const QVector<QByteArray> &records)
+{
+//  Write the whole paged file: every task gets a new slot, all pages are encrypted with fresh nonces
+//  The file is replaced atomically (QSaveFile), a journal left over for it is obsolete then.
+    int      i;
+    quint32  page, pages, k, random_number;
+    uint8_t  rootTag[CHUNK_TAG_SIZE];
+    uint8_t  *buffer, *data;
+    size_t   size;
+    bool     unique;
+    QByteArray digests, meta;
+    QSaveFile savefile(activeFile.SaveFileNameFull);
+    TRACE_SCOPE("CSaveFile::writePagedFull");
+
+    invalidateLayout();
+
+    // Assign the slots:
+    layout.pageCount = 0;
+    for (i=0; i<records.count(); i++) {
+        layout.pageCount += slotPages(records.at(i).size());
+    }
+    size   = (size_t) layout.pageCount * CHUNK_PAGE_STORED;
+    buffer = (uint8_t*) saveArena.alloc(size);
+    if (buffer == NULL) {
+        qWarning("Not enough memory to write save file: %s",activeFile.SaveFileNameFull.toUtf8().data());
+        logger.warning() << "writefileEncrypted(): Not enough memory to write save file: " << activeFile.SaveFileNameFull;
+        invalidateLayout();
+        return 1;
+    }
+
+    unique = true;
+    page   = 0;
+    for (i=0; i<records.count(); i++) {
+        pages = slotPages(records.at(i).size());
+        digests = QByteArray(pages * PAGE_DIGEST_SIZE, 0);
+        for (k=0; k<pages; k++) {
+            data = &buffer[(size_t) (page + k) * CHUNK_PAGE_STORED + CHUNK_PAGE_NONCE];
+            slotPage(pages, records.at(i), k, data);
+            pageDigest(digestKey, data, (uint8_t*) digests.data() + k * PAGE_DIGEST_SIZE);
+        }
+        if (layout.taskSlots.contains(store.taskID(i))) unique = false;
+        layout.taskSlots.insert(store.taskID(i), { page, pages, digests });
+        page += pages;
+    }
+
+    // Encrypt:
+    for (page=0; page<layout.pageCount; page++) {
+        for (k=0; k<CHUNK_PAGE_NONCE; k+=4) {
+            random_number = QRandomGenerator::global()->generate();
+            memcpy(&buffer[(size_t) page * CHUNK_PAGE_STORED + k], &random_number, 4);
+        }
+    }
+    CTraceScope encrypt("writePagedFull: sealPages");
+    chunks.sealPages(buffer, 0, layout.pageCount);
+    encrypt.end();
+    layout.tags.resize(layout.pageCount * CHUNK_TAG_SIZE);
+    for (page=0; page<layout.pageCount; page++) {
+        memcpy(layout.tags.data() + page * CHUNK_TAG_SIZE, &buffer[(size_t) page * CHUNK_PAGE_STORED + CHUNK_PAGE_NONCE + CHUNK_PAGE_SIZE], CHUNK_TAG_SIZE);
+    }
+    layout.saveCounter++;
+    meta = pageMeta();
+    chunks.rootTag((const uint8_t*) meta.constData(), meta.size(), (const uint8_t*) layout.tags.constData(), layout.pageCount, rootTag);
+    layout.rootTag = QByteArray((const char*) rootTag, CHUNK_TAG_SIZE);
+
+    // Write to file:
+    TRACE_SCOPE("writePagedFull: write");
+    QFile::remove(activeFile.SaveFileNameFull + ".journal");
+    if (!savefile.open(QIODevice::WriteOnly)) {
+        qWarning("Could not open save file: %s",activeFile.SaveFileNameFull.toUtf8().data());
+        logger.warning() << "writefileEncrypted(): Could not open save file: " << activeFile.SaveFileNameFull;
+        invalidateLayout();
+        return 1;
+    }
+    savefile.write(header);
+    savefile.write(meta);
+    savefile.write((const char*) rootTag, CHUNK_TAG_SIZE);
+    savefile.write((const char*) buffer, size);
+    if (!savefile.commit()) {
+        qWarning("Could not write save file: %s",activeFile.SaveFileNameFull.toUtf8().data());
+        logger.warning() << "writefileEncrypted(): Could not write save file: " << activeFile.SaveFileNameFull;
+        invalidateLayout();
+        return 1;
+    }
+
+    // Slots are found by task ID - if IDs are not unique, the next save writes the whole file again
+    if (unique) layout.file = activeFile.SaveFileNameFull;
+
+    return 0;
+}
+
+
+int CSaveFile::writePagedIncremental(const QVector<QByteArray> &records)
+{
+//  Rewrite only the pages that changed since the last save, in place
+//  A slot which became too small is released and the task gets a new slot (a free one or appended to the file).
+//  The changed pages and the new header go to a journal first (see replayJournal()), so an interruption never leaves
+//  a half-written file behind. The pages are built & sealed in saveArena, a page only kept if its digest changed.
+    int      i;
+    quint32  k, pages, random_number;
+    uint8_t  rootTag[CHUNK_TAG_SIZE];
+    uint8_t  digest[PAGE_DIGEST_SIZE];
+    uint8_t  *page;
+    QSet<quint32> present;
+    QMap<quint32, uint8_t*> dirty;     // Page no. -> new page as stored (nonce, plaintext & room for the tag; NULL: out of memory)
+    QMap<quint32, uint8_t*>::iterator d;
+    QHash<quint32, sSlot>::iterator it;
+    QByteArray before, meta, journalData;
+    QSaveFile journal(activeFile.SaveFileNameFull + ".journal");
+    SHA256 hash;
+    uint8_t checksum[32];
+    TRACE_SCOPE("CSaveFile::writePagedIncremental");
+
+    before = pageMeta();
+    before.append(layout.rootTag);
+
+    // Find the changed pages:
+    page = NULL;
+    for (i=0; i<records.count(); i++) {
+        present.insert(store.taskID(i));
+        it = layout.taskSlots.find(store.taskID(i));
+        if (it != layout.taskSlots.end() && (quint32) records.at(i).size() + 8 <= it->pages * CHUNK_PAGE_SIZE) {
+            // Task still fits into its slot - only pages with a new digest are written (an unchanged page is built over by the next one):
+            for (k=0; k<it->pages; k++) {
+                if (page == NULL) page = (uint8_t*) saveArena.alloc(CHUNK_PAGE_STORED);
+                if (page == NULL) {
+                    dirty.insert(it->firstPage + k, NULL);
+                    continue;
+                }
+                slotPage(it->pages, records.at(i), k, page + CHUNK_PAGE_NONCE);
+                pageDigest(digestKey, page + CHUNK_PAGE_NONCE, digest);
+                if (memcmp(digest, it->digests.constData() + k * PAGE_DIGEST_SIZE, PAGE_DIGEST_SIZE) != 0) {
+                    dirty.insert(it->firstPage + k, page);
+                    memcpy(it->digests.data() + k * PAGE_DIGEST_SIZE, digest, PAGE_DIGEST_SIZE);
+                    page = NULL;
+                }
+            }
+        }
+        else {
+            // New task, or the slot is too small:
+            if (it != layout.taskSlots.end()) {
+                releaseSlot(it->firstPage, it->pages, dirty);
+                layout.taskSlots.erase(it);
+            }
+            pages = slotPages(records.at(i).size());
+            sSlot slot = { allocateSlot(pages, dirty), pages, QByteArray(pages * PAGE_DIGEST_SIZE, 0) };
+            for (k=0; k<pages; k++) {
+                if (page == NULL) page = (uint8_t*) saveArena.alloc(CHUNK_PAGE_STORED);
+                if (page != NULL) {
+                    slotPage(pages, records.at(i), k, page + CHUNK_PAGE_NONCE);
+                    pageDigest(digestKey, page + CHUNK_PAGE_NONCE, (uint8_t*) slot.digests.data() + k * PAGE_DIGEST_SIZE);
+                }
+                dirty.insert(slot.firstPage + k, page);
+                page = NULL;
+            }
+            layout.taskSlots.insert(store.taskID(i), slot);
+        }
+    }
+    // Release the slots of removed tasks:
+    for (it = layout.taskSlots.begin(); it != layout.taskSlots.end(); ) {
+        if (present.contains(it.key())) {
+            ++it;
+        }
+        else {
+            releaseSlot(it->firstPage, it->pages, dirty);
+            it = layout.taskSlots.erase(it);
+        }
+    }
+
+    if (dirty.isEmpty()) {
+        qInfo("writefileEncrypted(): No changes to save.");
+        return 0;
+    }
+
+    // Encrypt the changed pages in place, each with a fresh nonce:
+    CTraceScope encrypt("writePagedIncremental: sealPage");
+    layout.tags.resize(layout.pageCount * CHUNK_TAG_SIZE);
+    for (d = dirty.begin(); d != dirty.end(); ++d) {
+        if (d.value() == NULL) {
+            qWarning("Not enough memory to write save file: %s",activeFile.SaveFileNameFull.toUtf8().data());
+            logger.warning() << "writefileEncrypted(): Not enough memory to write save file: " << activeFile.SaveFileNameFull;
+            invalidateLayout();
+            return 1;
+        }
+        for (k=0; k<CHUNK_PAGE_NONCE; k+=4) {
+            random_number = QRandomGenerator::global()->generate();
+            memcpy(d.value() + k, &random_number, 4);
+        }
+        chunks.sealPage(d.key(), d.value());
+        memcpy(layout.tags.data() + d.key() * CHUNK_TAG_SIZE, d.value() + CHUNK_PAGE_NONCE + CHUNK_PAGE_SIZE, CHUNK_TAG_SIZE);
+    }
+    layout.saveCounter++;
+    meta = pageMeta();
+    chunks.rootTag((const uint8_t*) meta.constData(), meta.size(), (const uint8_t*) layout.tags.constData(), layout.pageCount, rootTag);
+    meta.append((const char*) rootTag, CHUNK_TAG_SIZE);
+    encrypt.end();
+
+    // Journal: magic no., no. of entries, file information before & after, entries (offset, length, data), SHA256 of all this
+    QDataStream jout(&journalData, QIODevice::WriteOnly);
+    jout.setVersion(QDataStream::Qt_5_0);
+    jout << (quint32) 0x051076C0;
+    jout << (quint32) (dirty.count() + 1);
+    jout.writeRawData(before.constData(), before.size());
+    jout.writeRawData(meta.constData(), meta.size());
+    jout << (quint64) 54 << (quint32) meta.size();
+    jout.writeRawData(meta.constData(), meta.size());
+    for (d = dirty.begin(); d != dirty.end(); ++d) {
+        jout << (quint64) (PAGED_DATA_START + (quint64) d.key() * CHUNK_PAGE_STORED) << (quint32) CHUNK_PAGE_STORED;
+        jout.writeRawData((const char*) d.value(), CHUNK_PAGE_STORED);
+    }
+    hash.update(journalData.constData(), journalData.size());
+    hash.finalize(checksum, 32);
+    journalData.append((const char*) checksum, 32);
+
+    CTraceScope write("writePagedIncremental: write journal");
+    if (!journal.open(QIODevice::WriteOnly) || journal.write(journalData) != journalData.size() || !journal.commit()) {
+        qWarning("Could not write journal for save file: %s",activeFile.SaveFileNameFull.toUtf8().data());
+        logger.warning() << "writefileEncrypted(): Could not write journal for save file: " << activeFile.SaveFileNameFull;
+        invalidateLayout();
+        return 1;
+    }
+
+    write.end();
+
+    // Apply the journal:
+    TRACE_SCOPE("writePagedIncremental: apply journal");
+    if (!applyJournal(activeFile.SaveFileNameFull, journalData)) {
+        qWarning("Could not update save file: %s",activeFile.SaveFileNameFull.toUtf8().data());
+        logger.warning() << "writefileEncrypted(): Could not update save file (journal kept for the next load): " << activeFile.SaveFileNameFull;
+        invalidateLayout();
+        return 1;
+    }
+    QFile::remove(activeFile.SaveFileNameFull + ".journal");
+
+    layout.rootTag = QByteArray((const char*) rootTag, CHUNK_TAG_SIZE);
+
+    logger.info() << "writefileEncrypted(): Pages written: " << dirty.count() << " of " << layout.pageCount;
+
+    return 0;
+}
+
+
+quint32 CSaveFile::slotPages(int recordSize)
+{
+//  Slot size for a task record: slot header, record & room to grow (about a month of timelog entries)
+    return (8 + recordSize + SLOT_SLACK + CHUNK_PAGE_SIZE - 1) / CHUNK_PAGE_SIZE;
+}
+
+
+void CSaveFile::pageDigest(const uint8_t *digestKey, const uint8_t *page, uint8_t *digest)
+{
+//  Digest of the plaintext of a page: HMAC-SHA256 under the session's digestKey, truncated to PAGE_DIGEST_SIZE Bytes (thread-safe)
+//  Keyed, so the digests kept in ordinary memory tell nothing about the plaintext.
+    SHA256  hmac;
+    uint8_t full[32];
+
+    hmac.resetHMAC(digestKey, 32);
+    hmac.update(page, CHUNK_PAGE_SIZE);
+    hmac.finalizeHMAC(digestKey, 32, full, 32);
+    memcpy(digest, full, PAGE_DIGEST_SIZE);
+    clean(full, 32);
+}
+
+
+quint32 CSaveFile::allocateSlot(quint32 pages, QMap<quint32, uint8_t*> &dirty)
+{
+//  Find room for a slot of the given size: the first free slot large enough, otherwise at the end of the file
+    QMap<quint32, quint32>::iterator it;
+    quint32 first, rest;
+
+    for (it = layout.freeSlots.begin(); it != layout.freeSlots.end(); ++it) {
+        if (it.value() >= pages) {
+            first = it.key();
+            rest  = it.value() - pages;
+            layout.freeSlots.erase(it);
+            layout.freePages -= pages + rest;
+            if (rest > 0) releaseSlot(first + pages, rest, dirty);
+            return first;
+        }
+    }
+
+    first = layout.pageCount;
+    layout.pageCount += pages;
+    return first;
+}
+
+
+void CSaveFile::releaseSlot(quint32 first, quint32 pages, QMap<quint32, uint8_t*> &dirty)
+{
+//  Mark a slot as unused, merged with unused neighbours - only the first page of the (merged) slot has to be written
+    QMap<quint32, quint32>::iterator it;
+    uint8_t *page;
+
+    layout.freePages += pages;
+    it = layout.freeSlots.find(first + pages);
+    if (it != layout.freeSlots.end()) {
+        pages += it.value();
+        layout.freeSlots.erase(it);
+    }
+    it = layout.freeSlots.lowerBound(first);
+    if (it != layout.freeSlots.begin()) {
+        --it;
+        if (it.key() + it.value() == first) {
+            first  = it.key();
+            pages += it.value();
+        }
+    }
+    layout.freeSlots.insert(first, pages);
+    page = (uint8_t*) saveArena.alloc(CHUNK_PAGE_STORED);
+    if (page != NULL) slotPage(pages, QByteArray(), 0, page + CHUNK_PAGE_NONCE);
+    dirty.insert(first, page);
+}
+
+
+bool CSaveFile::applyJournal(const QString &File, const QByteArray &journalData)
+{
+//  Write the entries of a (verified) journal into the save file and flush it to disk
+    QDataStream in(journalData);
+    QFile   savefile(File);
+    quint32 magic, entries, length, n;
+    quint64 offset;
+    QByteArray data;
+
+    in.setVersion(QDataStream::Qt_5_0);
+    in >> magic >> entries;
+    in.skipRawData(2 * PAGED_META_SIZE);
+    if (!savefile.open(QIODevice::ReadWrite)) return false;
+    for (n=0; n<entries; n++) {
+        in >> offset >> length;
+        data.resize(length);
+        if (in.readRawData(data.data(), length) != (int) length) return false;
+        if (!savefile.seek(offset) || savefile.write(data) != data.size()) return false;
+    }
+
+    return syncFile(savefile);
+}
+
+
+bool CSaveFile::replayJournal(const QString &File)
+{
+//  Complete an interrupted incremental save (see writePagedIncremental()) - called before loading a file
+//  The journal is applied if the file is still in the state it was written for, or has its new header already (interrupted while
+//  applying the journal - writing the entries again is harmless). Otherwise it's obsolete and discarded.
+    QFile   journal(File + ".journal");
+    QFile   savefile(File);
+    QByteArray journalData, current;
+    SHA256  hash;
+    uint8_t checksum[32];
+    bool    ok;
+    TRACE_SCOPE("CSaveFile::replayJournal");
+
+    if (!journal.exists()) return true;
+
+    ok = journal.open(QIODevice::ReadOnly);
+    if (ok) {
+        journalData = journal.readAll();
+        journal.close();
+    }
+    ok = ok && journalData.size() >= 8 + 2 * PAGED_META_SIZE + 32;
+    if (ok) {
+        hash.update(journalData.constData(), journalData.size() - 32);
+        hash.finalize(checksum, 32);
+        ok = (memcmp(checksum, journalData.constData() + journalData.size() - 32, 32) == 0);
+        ok = ok && qFromBigEndian<quint32>(journalData.constData()) == 0x051076C0;
+    }
+    if (ok && savefile.open(QIODevice::ReadOnly)) {
+        savefile.seek(54);
+        current = savefile.read(PAGED_META_SIZE);
+        savefile.close();
+    }
+
+    if (ok && (current == journalData.mid(8, PAGED_META_SIZE) || current == journalData.mid(8 + PAGED_META_SIZE, PAGED_META_SIZE))) {
+        qInfo("replayJournal(): Completing interrupted save of %s",File.toUtf8().data());
+        logger.info() << "replayJournal(): Completing interrupted save: " << File;
+        if (!applyJournal(File, journalData)) {
+            qWarning("replayJournal(): Could not update save file %s!",File.toUtf8().data());
+            logger.warning() << "replayJournal(): Could not update save file: " << File;
+            return false;
+        }
+    }
+    else {
+        qWarning("replayJournal(): Discarding invalid or obsolete journal for %s",File.toUtf8().data());
+        logger.warning() << "replayJournal(): Discarding invalid or obsolete journal: " << File;
+    }
+    QFile::remove(File + ".journal");
+
+    return true;
+}
+
+
+bool CSaveFile::syncFile(QFile &file)
+{
+//  Flush a file to disk (QFile::flush() only hands Qt's buffer to the operating system)
+    if (!file.flush()) return false;
+#if defined(Q_OS_WIN)
+    return _commit(file.handle()) == 0;
+#else
+    return fsync(file.handle()) == 0;
+#endif
+}
+
+
+void CSaveFile::invalidateLayout()
+{
+//  Forget the page layout of the active file - the next encrypted save writes the whole file
+    layout.taskSlots.clear();
+    layout.freeSlots.clear();
+    layout.tags.clear();
+    layout.rootTag.clear();
+    layout.pageCount = 0;
+    layout.freePages = 0;
+    layout.file      = "";
+}
+
+
+void CSaveFile::backupfile()
+{
+//  Backup the current data file
+    QFile savefile;
+    QFile backupfile;
+    QString newname;
+    TRACE_SCOPE("CSaveFile::backupfile");
+
+
+    newname = activeFile.SaveFileNameFull;
+    newname.append(".bak");
+    backupfile.setFileName(newname);
+
+    // Remove old backup:
+    backupfile.remove();
+
+    // Copy current save file to backup (does not overwrite an existing file):
+    savefile.setFileName(activeFile.SaveFileNameFull);
+    if (!savefile.copy(newname)) {
+        qWarning("backupfile(): Could not create backup file: %s",newname.toUtf8().data());
+        logger.warning() << "backupfile(): Could not create backup file: " << newname;
+    }
+
+}
@@ -0,0 +1,219 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CSAVEFILE_H
+#define CSAVEFILE_H
+
+#include <QObject>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QTextStream>
+#include <QtConcurrent>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QtEndian>
+#include "crypto/Crypto.h"
+#include "crypto/CBC.h"
+#include "crypto/ChunkCipher.h"
+#include "crypto/AES.h"
+#include "crypto/SHA256.h"
+#include "crypto/pbkdf2.h"
+#include "crypto/SecureMem.h"
+#include "crypto/SecureArena.h"
+#include "CTaskStore.h"
+#include "CLogger.h"
+
+// Paged save files (version 103): file information & root tag following the 54 Byte header, start of the pages
+#define PAGED_META_SIZE   48
+#define PAGED_DATA_START  102
+// Room to grow for each task slot (in Bytes), so adding timelog entries rarely moves a task
+#define SLOT_SLACK        512
+// Bytes of an encrypted file read & decrypted at a time when loading
+#define LOAD_WINDOW       (4*1024*1024)
+// Keyed digest of the plaintext of a page, kept for every page of the active file to find the pages changed since
+#define PAGE_DIGEST_SIZE  16
+
+
+// Loading & saving the tasks of a CTaskStore: file formats, encryption, the journal of incremental saves, backup & CSV export.
+//
+// Part of the core library (see core.pri): QtCore & QtConcurrent only. Encrypted files are decrypted by a worker thread;
+// the signals are emitted on the thread owning this object, which must also own the store.
+// A load replaces all tasks of the store - tasksAboutToBeReplaced() and tasksReplaced() enclose this.
+class CSaveFile : public QObject
+{
+    Q_OBJECT
+    friend class CModelBenchmark;   // Writes synthetic save files of older versions
+
+public:
+    typedef CTaskStore::Task  Task;
+    typedef CTaskStore::sTime sTime;
+
+    struct sFile {
+        QString SaveFileName;          // Holds name of the currently used save file
+        QString SaveFileNameFull;      // Holds full path to the currently used save file
+        quint32 magic_no;              // File type magic number (0x051076A0: Unencrypted, 0x051076B0: Encrypted)
+        quint16 version_no;            // Save file version number - selects the key derivation for encrypted files
+        uint8_t encrypted;             // File is encrypted [1] or not [0]
+        uint8_t salt[16];              // The salt used with this password
+        QString Password;              // The password to use for this file
+        uint8_t PasswordHashRead[32];  // The hashed password read from this file
+    };
+
+    CSaveFile(CTaskStore &store, CLogger &logger, QObject *parent = nullptr);
+    ~CSaveFile();
+
+    const sFile &active() const  { return activeFile; }   // The file currently loaded
+    const sFile &pending() const { return newFile; }      // The file being (or last) checked or loaded
+
+    bool checkFileType(const QString &File);
+    void load_data(const QString &PW, const QString &File);
+    void cancelLoad();
+    int  save_data(const QString &File);
+    void set_password(const QString &PW);
+    void removeEncryption();
+    void close();
+    void backupfile();
+    QString csvWriter();
+
+    bool readfile(QString filename, QList<Task> &tasks);
+    static int recordSize(const uint8_t *record, size_t avail);
+    int  writefile();
+    int  writefileEncrypted();
+    QByteArray serializeTask(int i, SecureArena &arena);
+    static void slotPage(quint32 pages, const QByteArray &record, quint32 k, uint8_t *page);
+    QByteArray pageMeta();
+    int  writePagedFull(const QByteArray &header, const QVector<QByteArray> &records);
+    int  writePagedIncremental(const QVector<QByteArray> &records);
+    static quint32 slotPages(int recordSize);
+    static void pageDigest(const uint8_t *digestKey, const uint8_t *page, uint8_t *digest);
+    quint32 allocateSlot(quint32 pages, QMap<quint32, uint8_t*> &dirty);
+    void releaseSlot(quint32 first, quint32 pages, QMap<quint32, uint8_t*> &dirty);
+    bool applyJournal(const QString &File, const QByteArray &journalData);
+    bool replayJournal(const QString &File);
+    static bool syncFile(QFile &file);
+    void invalidateLayout();
+    void invalidateKeyCache();
+    static int deriveKey(const QString &Password, const uint8_t *Salt, quint16 Version, uint8_t *Key, pbkdf2_progress_cb progress = NULL, void *ctx = NULL);
+
+
+signals:
+    void passwordNeeded(quint8 needed);       // The file checked or loaded is encrypted (1) or not (0)
+    void loadStarted();                       // An encrypted file is being decrypted by the worker
+    void loadProgressChanged(int percent);    // Progress of the worker (0-100)
+    void loaded(int status);                  // 0: OK, 1: Wrong password, 2: Cancelled, 3: File could not be read, 4: File damaged or modified
+    void tasksAboutToBeReplaced();
+    void tasksReplaced();
+
+
+private:
+    CTaskStore &store;
+    CLogger    &logger;
+    sFile  activeFile;      // The file currently loaded
+    sFile  newFile;         // Temporary file object for loading operations
+
+    // Crypto
+    // Encryption works as follows:
+    // Version 103 files: Every task is stored in a slot of consecutive 1 kB pages, each encrypted with AES256 in CTR mode
+    // under its own random nonce and followed by an HMAC-SHA256 tag (see ChunkCipher). A root tag over all page tags, the
+    // page count and a save counter follows the header, so pages can't be swapped, replayed or dropped. Saving only
+    // re-encrypts and rewrites the pages that changed; the changes go through a journal file ("<file>.journal") first.
+    // Version 102 files (read only): All time data is split into chunks of 64 kB, each encrypted with AES256 in CTR mode and followed by
+    // an HMAC-SHA256 tag (see ChunkCipher). The nonce is random for every save and stored in front of the chunks.
+    // The tags cover the unencrypted file header as well, so any modification or truncation of the file is detected on loading.
+    // Version 100/101 files (read only): All time data is encrypted in Cipher Block Chaining mode using a random IV.
+    // 16 Bytes of null data are prepended when writing the file and discarded on read so we don't need to remember the IV.
+    // Saving always writes version 103.
+    // The encryption key is derived from the user password and a random salt using a PBKDF2 function
+    // (HMAC-SHA1 with 4096 iterations for version 100 files, HMAC-SHA256 with 10000 iterations for version 101-103 files).
+    // The salt and the hashed password are stored within the encrypted file (the salt to generate the encryption key for decryption,
+    // the hashed password to check whether the entered password is correct).
+    // The derived key and the chunk keys are cached for the active file, so saving does not have to run PBKDF2 again.
+    // They are kept in locked memory and are wiped whenever the password, the salt or the active file changes.
+    ChunkCipher chunks;    // Chunked AES256-CTR + HMAC-SHA256 (used for saving)
+    SHA256  sha256;        // Hashing algorithm
+    uint8_t key[32];       // The key derived from the password (this is not the password!)
+    uint8_t keyCached;     // 1 if key and the keys in chunks are valid for activeFile, 0 otherwise
+    uint8_t PasswordHash[32];   // The hashed password (for saving in the encrypted file & comparing entered password with saved one)
+    uint8_t digestKey[32]; // Random key of the page digests (see pageDigest(), never saved)
+
+    // Page layout of the active (version 103) file, as of the last load/save
+    struct sSlot {
+        quint32    firstPage;        // First page of the slot
+        quint32    pages;            // No. of pages
+        QByteArray digests;          // Digest of each page as saved (compared with the current data to find changed pages)
+    };
+    struct sPageLayout {
+        sPageLayout() : pageCount(0), freePages(0), saveCounter(0) {}
+        quint32    pageCount;        // No. of pages in the file
+        quint32    freePages;        // No. of pages in unused slots
+        quint64    saveCounter;      // Incremented with every save (part of the root tag)
+        QByteArray tags;             // The tags of all pages
+        QByteArray rootTag;          // The root tag as in the file
+        QHash<quint32, sSlot>   taskSlots;   // Slots by taskID
+        QMap<quint32, quint32>  freeSlots;   // Unused slots: first page -> no. of pages
+        QString    file;             // The file this layout belongs to (empty: the next save writes the whole file)
+    };
+    sPageLayout layout;
+    SecureArena saveArena;   // Task records & pages of writefileEncrypted(), plaintext & sealed (locked memory, wiped after each save)
+
+    // Decodes task records (see serializeTask()) from decrypted data handed over piece by piece
+    struct sRecordReader {
+        sRecordReader();
+        ~sRecordReader();
+        QDate       today;           // Date, month & year the file is loaded (times saved before are reset)
+        quint8      thisMonth;
+        quint16     thisYear;
+        QList<Task> tasks;           // The tasks decoded so far
+        QVector<qint32> rows;        // The saved row of each task
+        QByteArray  carry;           // Start of a record continued in the next piece
+        bool feed(const uint8_t *data, size_t len);
+        bool pending() const { return !carry.isEmpty(); }
+        void decode(const uint8_t *record);
+    };
+
+    // Loading an encrypted file
+    // Password check, key derivation and decryption run in a worker thread, so the GUI and the task timer keep running.
+    // The worker only touches its own job object; the tasks are handed to the store on the thread owning this object.
+    struct sLoadJob {
+        sLoadJob();
+        ~sLoadJob();
+        sFile       file;            // The file to load (copy of newFile)
+        QString     filename;        // Full path of the file to load
+        CSaveFile   *owner;          // Receiver of progress reports
+        QAtomicInt  cancel;          // Set to 1 to abort the job
+        quint32     generation;      // Job counter - progress reports of older jobs are ignored
+        int         status;          // Result, see loaded()
+        int         lastProgress;    // Last progress value reported (worker thread only)
+        uint8_t     key[32];         // The derived key (locked memory, becomes the session key on success)
+        uint8_t     digestKey[32];   // Key of the page digests (copy of the owner's)
+        sRecordReader reader;        // The tasks decoded from the file
+        SecureArena *arena;          // Memory for the decryption window (loadArena)
+        sPageLayout layout;          // Page layout (version 103 only)
+    };
+    static void decryptfile(QSharedPointer<sLoadJob> job);
+    static int  loadProgress(void *ctx, unsigned int done, unsigned int total);
+    static void postProgress(sLoadJob *job, int percent);
+    void setLoadProgress(quint32 generation, int percent);
+    void finishLoad();
+
+    QSharedPointer<sLoadJob> loadJob;       // The job currently running (or last run)
+    QFutureWatcher<void>     loadWatcher;   // Signals the end of loadJob
+    SecureArena              loadArena;     // Decryption window of the load jobs (locked memory, wiped after each job)
+    quint32                  loadGeneration;
+    bool                     decrypting;    // A job is running and has not been finished yet
+};
+
+#endif // CSAVEFILE_H
@@ -0,0 +1,1151 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <QSet>
+#include <QHash>
+#include <QRandomGenerator>
+#include "CTaskStore.h"
+#include "CTrace.h"
+
+
+CTaskStore::CTaskStore(CLogger &logger) : logger(logger)
+{
+    // Memorize the current date
+    m_today     = QDate::currentDate();
+    m_thisMonth = (quint8)  m_today.month();
+    m_thisYear  = (quint16) m_today.year();
+
+    memset(&m_totals, 0, sizeof(m_totals));
+    m_batchDepth = 0;
+    m_undoDepth  = 0;
+    m_aggregateValid = false;
+}
+
+
+int CTaskStore::row(qint32 taskID) const
+{
+//  Return the row corresponding to a given taskID
+//  Returns -1 if taskID not found
+    return m_hot.taskID.indexOf((quint32) taskID);
+}
+
+
+void CTaskStore::setTasks(const QList<Task> &tasks)
+{
+//  Replace all tasks (e.g. with the tasks of a file just loaded) and compute their times for the current date
+//  Only the title, description, ID & timelog of each task are taken, the times are recomputed.
+    int i;
+    TRACE_SCOPE("CTaskStore::setTasks");
+
+    // The undo steps belong to the tasks replaced:
+    clearUndo();
+    m_hot.clear();
+    m_records.clear();
+    m_freeRecords.clear();
+    m_aggregateValid = false;
+    m_records.reserve(tasks.count());
+    for (i=0; i<tasks.count(); i++) {
+        insertTask(i, tasks.at(i));
+    }
+    refresh();
+}
+
+
+int CTaskStore::append(const QString &title, const QString &description)
+{
+//  Add a new empty entry at the end of the task list (unsorted), returns its row
+    QMap<QDate, sTime> entry;
+    quint16 UID;
+    int row;
+
+    entry.insert(m_today, makeTime(0));
+
+    // Generate 16 Bit random UID, making sure it is not used yet:
+    do {
+        UID = QRandomGenerator::global()->generate() >> 16;
+    } while (this->row(UID) >= 0);
+
+    row = count();
+    m_hot.insert(row, UID, newRecord({ title, description, entry }));
+    return row;
+}
+
+
+void CTaskStore::set(int row, const QString &title, const QString &description)
+{
+//  Update title or description of an entry
+    if (row < 0 || row >= count())
+        return;
+
+    record(row).title       = title;
+    record(row).description = description;
+}
+
+
+void CTaskStore::setTime(int row, const QDate &date, const sTime &time)
+{
+//  Update time contents of an arbitrary "date" in an arbitrary entry "row" of the task list to "time"
+    if (row < 0 || row >= count())
+        return;
+
+    record(row).timelog.insert(date, time);   // Overwrites existing entries with new value
+    m_aggregate.set(m_hot.record.at(row), date, time.elapsedSeconds);
+    if (m_batchDepth > 0) m_batchTasks.insert(taskID(row));
+    else                  refreshTask(row);
+}
+
+
+void CTaskStore::addTime(int row, const QDate &date, int seconds)
+{
+//  Add time to task in "row" at "date" (negative: subtract, limited to 0)
+    qint64 elapsedSeconds;
+
+    if (row < 0 || row >= count())
+        return;
+
+    elapsedSeconds = (qint64) timelog(row).value(date).elapsedSeconds + seconds;
+    if (elapsedSeconds < 0) elapsedSeconds = 0;
+
+    setTime(row, date, makeTime((quint32) elapsedSeconds));
+}
+
+
+void CTaskStore::setActive(int row, quint8 active)
+{
+//  Mark the task as counting time (1) or not (0)
+    if (row < 0 || row >= count())
+        return;
+
+    m_hot.active[row] = active;
+}
+
+
+void CTaskStore::setAllocate(int row, quint8 allocate)
+{
+//  Mark the task as target for time allocation (1) or not (0)
+    if (row < 0 || row >= count())
+        return;
+
+    m_hot.allocate[row] = allocate;
+}
+
+
+void CTaskStore::resetAllocate()
+{
+//  Reset all flags marking tasks as target for time allocation
+    int i;
+
+    for (i=0; i<count(); i++) {
+        m_hot.allocate[i] = 0;
+    }
+}
+
+
+bool CTaskStore::reallocate(int row, const QDate &date, bool weighted)
+{
+//  Reallocate the time of the task in "row" on "date" to the targets marked for time allocation
+//  weighted: Reallocate time weighted by the time on the target tasks on that date (true) or equally (false)
+//  Returns false if there are no targets.
+    return reallocateRange(row, date, date, weighted);
+}
+
+
+bool CTaskStore::reallocateAll(int row, bool weighted)
+{
+//  Reallocate the time of the task in "row" for all days to the targets marked for time allocation
+//  Weighted reallocation is performed for each single day, i.e. only the target tasks' time for each day is considered in the weighting
+    return reallocateRange(row, QDate(), QDate(), weighted);
+}
+
+
+bool CTaskStore::reallocateRange(int row, const QDate &from, const QDate &to, bool weighted)
+{
+//  Reallocate the time of the task in "row" for all days from "from" to "to" (inclusive; an invalid date leaves that end open)
+//  to the targets marked for time allocation. The whole transfer is planned first, then applied as one batch.
+//  Returns false if there are no targets (nothing is changed then).
+    QVector<sTransfer> plan;
+    int i;
+    TRACE_SCOPE("CTaskStore::reallocateRange");
+
+    if (row < 0 || row >= count())
+        return false;
+
+    if (!planReallocation(row, from, to, weighted, plan)) {
+        qWarning("CTaskStore::reallocate(%d): No targets to allocate to!",row);
+        logger.warning() << "reallocate(): No targets to allocate to!";
+        return false;
+    }
+
+    beginBatch();
+    for (i=0; i<plan.count(); i++) {
+        setTime(plan.at(i).row, plan.at(i).date, makeTime(plan.at(i).seconds));
+    }
+    commitBatch();
+
+    return true;
+}
+
+
+bool CTaskStore::planReallocation(int row, const QDate &from, const QDate &to, bool weighted, QVector<sTransfer> &plan) const
+{
+//  Plan the reallocation of the time of the task in "row" from "from" to "to" (see reallocateRange()): one entry per
+//  timelog entry to set. Walks the source timelog & the timelogs of the targets once, side by side.
+//  Returns false if there are no targets.
+    QVector<int> targets;
+    QVector<QMap<QDate, sTime>::const_iterator> pos;
+    QVector<quint32> current, weights, shares;
+    QMap<QDate, sTime>::const_iterator it, last;
+    const QMap<QDate, sTime> &source = timelog(row);
+    quint32 sum;
+    int i;
+
+    plan.clear();
+
+    // The source itself is never a target:
+    for (i=0; i<count(); i++) {
+        if (allocate(i)==1 && i != row) targets.append(i);
+    }
+    if (targets.isEmpty()) return false;
+
+    current.resize(targets.count());
+    weights.resize(targets.count());
+    for (i=0; i<targets.count(); i++) {
+        const QMap<QDate, sTime> &timelog = this->timelog(targets.at(i));
+        pos.append(from.isValid() ? timelog.lowerBound(from) : timelog.constBegin());
+    }
+
+    it   = from.isValid() ? source.lowerBound(from) : source.constBegin();
+    last = to.isValid()   ? source.upperBound(to)   : source.constEnd();
+    for (; it != last; ++it) {
+        if (it.value().elapsedSeconds == 0) continue;
+
+        // Time of each target on that date (the dates only increase, so each target iterator only moves forward):
+        sum = 0;
+        for (i=0; i<targets.count(); i++) {
+            const QMap<QDate, sTime> &timelog = this->timelog(targets.at(i));
+            while (pos.at(i) != timelog.constEnd() && pos.at(i).key() < it.key()) ++pos[i];
+            current[i] = (pos.at(i) != timelog.constEnd() && pos.at(i).key() == it.key()) ? pos.at(i).value().elapsedSeconds : 0;
+            sum += current.at(i);
+        }
+
+        // Weighted by the targets' time on that date, equally if they all have none:
+        for (i=0; i<targets.count(); i++) {
+            weights[i] = (weighted && sum > 0) ? current.at(i) : 1;
+        }
+        apportion(it.value().elapsedSeconds, weights, shares);
+
+        plan.append({ row, it.key(), 0 });
+        for (i=0; i<targets.count(); i++) {
+            if (shares.at(i) > 0) plan.append({ targets.at(i), it.key(), current.at(i) + shares.at(i) });
+        }
+    }
+
+    return true;
+}
+
+
+void CTaskStore::apportion(quint32 amount, const QVector<quint32> &weights, QVector<quint32> &shares)
+{
+//  Split "amount" in proportion to "weights" by the largest remainder method: every share is rounded down, the
+//  seconds left over go one each to the largest remainders (ties: lower index first). The shares always sum up to amount.
+    QVector<int> order;
+    QVector<quint64> remainders;
+    quint64 sum, exact;
+    quint32 left;
+    int i;
+
+    shares.fill(0, weights.count());
+    sum = 0;
+    for (i=0; i<weights.count(); i++) sum += weights.at(i);
+    if (sum == 0) return;
+
+    remainders.resize(weights.count());
+    left = amount;
+    for (i=0; i<weights.count(); i++) {
+        exact = quint64(amount) * weights.at(i);
+        shares[i]     = quint32(exact / sum);
+        remainders[i] = exact % sum;
+        left         -= shares.at(i);
+        order.append(i);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return remainders.at(a) > remainders.at(b); });
+    for (i=0; i<(int) left; i++) {
+        shares[order.at(i)]++;
+    }
+}
+
+
+
+void CTaskStore::resetToday(int row)
+{
+//  Reset today's logged time for task
+    setTime(row, m_today, makeTime(0));
+}
+
+
+void CTaskStore::resetTotal(int row)
+{
+//  Reset total logged time for task
+    QMap<QDate, sTime> entry;
+
+    if (row < 0 || row >= count())
+        return;
+
+    // Start a fresh new timelog:
+    entry.insert(m_today, makeTime(0));
+    record(row).timelog = entry;
+    m_aggregateValid = false;
+    m_hot.seconds[Daily][row]   = 0;
+    m_hot.seconds[Monthly][row] = 0;
+    m_hot.seconds[Yearly][row]  = 0;
+    refreshTask(row);
+}
+
+
+void CTaskStore::remove(int row)
+{
+//  Remove an entry from the list
+    if (row < 0 || row >= count())
+        return;
+
+    removeRow(row);
+}
+
+
+void CTaskStore::clear()
+{
+//  Remove all tasks from the list
+    m_hot.clear();
+    m_records.clear();
+    m_freeRecords.clear();
+    m_aggregateValid = false;
+}
+
+
+int CTaskStore::importTimes(const QStringList &titles, const QVector<QMap<QDate, quint32>> &times)
+{
+//  Bulk import (see CCsvImport): the seconds per day of the tasks named in "titles" replace the times logged on those days,
+//  tasks not found by title are appended. All times are recomputed once at the end.
+//  Returns the no. of tasks appended
+    QHash<QString, int> rows;
+    QMap<QDate, quint32>::const_iterator it;
+    int i, row, appended;
+    TRACE_SCOPE("CTaskStore::importTimes");
+
+    // The first task with a given title gets the times:
+    for (i=count()-1; i>=0; i--) {
+        rows.insert(title(i), i);
+    }
+
+    appended = 0;
+    for (i=0; i<titles.count() && i<times.count(); i++) {
+        row = rows.value(titles.at(i), -1);
+        if (row < 0) {
+            row = append(titles.at(i), "");
+            rows.insert(titles.at(i), row);
+            appended++;
+        }
+        QMap<QDate, sTime> &timelog = record(row).timelog;
+        for (it = times.at(i).constBegin(); it != times.at(i).constEnd(); ++it) {
+            timelog.insert(it.key(), makeTime(it.value()));
+        }
+    }
+
+    m_aggregateValid = false;
+    refresh();
+    return appended;
+}
+
+
+void CTaskStore::beginBatch()
+{
+//  Start a batch of timelog edits (see commitBatch())
+    m_batchDepth++;
+}
+
+
+void CTaskStore::commitBatch()
+{
+//  End a batch of timelog edits: recompute the times of each task edited once
+//  (tasks removed in the meantime are skipped)
+    QSet<quint32>::const_iterator it;
+    int row;
+    TRACE_SCOPE("CTaskStore::commitBatch");
+
+    if (m_batchDepth == 0) return;
+    if (--m_batchDepth > 0) return;
+
+    for (it = m_batchTasks.constBegin(); it != m_batchTasks.constEnd(); ++it) {
+        row = this->row(*it);
+        if (row >= 0) refreshTask(row);
+    }
+    m_batchTasks.clear();
+}
+
+
+void CTaskStore::beginUndoStep(const QString &label)
+{
+//  Start an undo step: all edits until commitUndoStep() are undone together
+//  Steps nest, the outermost commit records the step; its label is the first one given.
+    if (m_undoDepth++ == 0) {
+        m_undoHot     = m_hot;       // Shares all data with the store until it is edited
+        m_undoRecords = m_records;
+        m_undoLabel = label;
+    }
+    else if (m_undoLabel.isEmpty()) {
+        m_undoLabel = label;
+    }
+}
+
+
+void CTaskStore::commitUndoStep()
+{
+//  End an undo step: keep what the edits since beginUndoStep() changed - the days edited of each task changed (plus its
+//  title & description), the tasks removed as a whole and the IDs of the tasks added.
+//  Untouched timelogs are still shared with the copy made by beginUndoStep() and are skipped; the copy is dropped here,
+//  so a step only keeps the days it changed.
+    QHash<quint32, int> rows;
+    QSet<quint32> before;
+    sUndoStep step;
+    sUndoEntry entry;
+    int i, row;
+    TRACE_SCOPE("CTaskStore::commitUndoStep");
+
+    if (m_undoDepth == 0) return;
+    if (--m_undoDepth > 0) return;
+
+    for (i=0; i<count(); i++) {
+        rows.insert(taskID(i), i);
+    }
+
+    // Compare the records by row - a slot freed by a task removed may have been reused:
+    for (i=0; i<m_undoHot.taskID.count(); i++) {
+        const sRecord &old = m_undoRecords.at(m_undoHot.record.at(i));
+        entry = sUndoEntry();
+        entry.taskID = m_undoHot.taskID.at(i);
+        entry.row    = i;
+        before.insert(entry.taskID);
+        row = rows.value(entry.taskID, -1);
+        if (row < 0) {
+            entry.kind = TaskRemoved;
+            entry.task = makeTask(m_undoHot, m_undoRecords, i);
+            step.entries.append(entry);
+            continue;
+        }
+
+        if (!old.timelog.isSharedWith(timelog(row))) diffTimelogs(old.timelog, timelog(row), entry.days);
+        if (entry.days.isEmpty() && old.title == title(row) && old.description == description(row)) continue;
+        entry.kind           = TaskChanged;
+        entry.title[0]       = old.title;
+        entry.title[1]       = title(row);
+        entry.description[0] = old.description;
+        entry.description[1] = description(row);
+        step.entries.append(entry);
+    }
+    for (i=0; i<count(); i++) {
+        if (before.contains(taskID(i))) continue;
+        entry = sUndoEntry();
+        entry.taskID = taskID(i);
+        entry.row    = i;
+        entry.kind   = TaskAdded;
+        step.entries.append(entry);
+    }
+    m_undoHot.clear();
+    m_undoRecords.clear();
+
+    if (step.entries.isEmpty()) return;
+
+    step.label = m_undoLabel.isEmpty() ? QString("Edit") : m_undoLabel;
+    m_undo.append(step);
+    if (m_undo.count() > UNDO_LEVELS) m_undo.removeFirst();
+    m_redo.clear();
+}
+
+
+void CTaskStore::diffTimelogs(const QMap<QDate, sTime> &before, const QMap<QDate, sTime> &after, QVector<sDayChange> &days)
+{
+//  Collect the days that differ between two timelogs (walked side by side, both are sorted by date)
+    QMap<QDate, sTime>::const_iterator a, b;
+
+    a = before.constBegin();
+    b = after.constBegin();
+    while (a != before.constEnd() || b != after.constEnd()) {
+        if (b == after.constEnd() || (a != before.constEnd() && a.key() < b.key())) {
+            days.append({ a.key(), a.value().elapsedSeconds, -1 });
+            ++a;
+        }
+        else if (a == before.constEnd() || b.key() < a.key()) {
+            days.append({ b.key(), -1, b.value().elapsedSeconds });
+            ++b;
+        }
+        else {
+            if (a.value().elapsedSeconds != b.value().elapsedSeconds) days.append({ a.key(), a.value().elapsedSeconds, b.value().elapsedSeconds });
+            ++a;
+            ++b;
+        }
+    }
+}
+
+
+bool CTaskStore::undo(QVector<int> &rows)
+{
+//  Undo the last step, it can be redone afterwards
+//  rows: Rows recomputed (after the tasks removed/added by the step are back/gone)
+//  Returns false if there is nothing to undo
+    sUndoStep step;
+    TRACE_SCOPE("CTaskStore::undo");
+
+    if (m_undo.isEmpty() || m_undoDepth > 0) return false;
+
+    step = m_undo.takeLast();
+    applyStep(step, false, rows);
+    m_redo.append(step);
+    return true;
+}
+
+
+bool CTaskStore::redo(QVector<int> &rows)
+{
+//  Redo the last step undone (see undo())
+    sUndoStep step;
+    TRACE_SCOPE("CTaskStore::redo");
+
+    if (m_redo.isEmpty() || m_undoDepth > 0) return false;
+
+    step = m_redo.takeLast();
+    applyStep(step, true, rows);
+    m_undo.append(step);
+    return true;
+}
+
+
+void CTaskStore::clearUndo()
+{
+//  Forget all undo & redo steps (e.g. when another file is loaded)
+    m_undo.clear();
+    m_redo.clear();
+}
+
+
+void CTaskStore::applyStep(sUndoStep &step, bool redo, QVector<int> &rows)
+{
+//  Undo (redo false) or redo a step. The days a step changed get the difference between the two states added, so time
+//  counted on them since (e.g. by the running task) stays; the other days are left as they are. Tasks added by the step
+//  go on undo & come back on redo (tasks removed the other way round). Whether a task is running or marked for allocation
+//  does not change.
+    const eUndoKind going     = redo ? TaskRemoved : TaskAdded;
+    const eUndoKind returning = redo ? TaskAdded : TaskRemoved;
+    QMap<QDate, sTime>::iterator it;
+    QVector<int> inserted;
+    qint64 from, to, seconds;
+    int i, n, row;
+
+    rows.clear();
+
+    // Tasks going are kept whole - their rows are all taken first, so putting them back in ascending order restores them:
+    for (i=0; i<step.entries.count(); i++) {
+        sUndoEntry &entry = step.entries[i];
+        if (entry.kind != going) continue;
+        entry.row = this->row(entry.taskID);
+        if (entry.row >= 0) entry.task = task(entry.row);
+    }
+    for (i=0; i<step.entries.count(); i++) {
+        if (step.entries.at(i).kind != going) continue;
+        row = this->row(step.entries.at(i).taskID);
+        if (row >= 0) removeRow(row);
+    }
+
+    // Tasks changed get the difference of the days edited:
+    for (i=0; i<step.entries.count(); i++) {
+        const sUndoEntry &entry = step.entries.at(i);
+        if (entry.kind == returning) inserted.append(i);
+        if (entry.kind != TaskChanged) continue;
+        row = this->row(entry.taskID);
+        if (row < 0) continue;
+
+        sRecord &record = this->record(row);
+        record.title       = entry.title[redo ? 1 : 0];
+        record.description = entry.description[redo ? 1 : 0];
+        for (n=0; n<entry.days.count(); n++) {
+            const sDayChange &day = entry.days.at(n);
+            from = redo ? day.before : day.after;
+            to   = redo ? day.after  : day.before;
+            it   = record.timelog.find(day.date);
+            seconds = (it != record.timelog.end() ? (qint64) it.value().elapsedSeconds : 0) + qMax(to, (qint64) 0) - qMax(from, (qint64) 0);
+            if (seconds < 0) seconds = 0;
+            if (to < 0 && seconds == 0) {
+                if (it != record.timelog.end()) record.timelog.erase(it);
+            }
+            else {
+                record.timelog.insert(day.date, makeTime((quint32) seconds));
+            }
+        }
+        m_aggregateValid = false;
+    }
+
+    // Tasks returning come back to their former rows (in ascending order, so these are right again):
+    std::sort(inserted.begin(), inserted.end(), [&](int a, int b) { return step.entries.at(a).row < step.entries.at(b).row; });
+    for (i=0; i<inserted.count(); i++) {
+        sUndoEntry &entry = step.entries[inserted.at(i)];
+        if (entry.row < 0) continue;   // Was gone already
+        insertTask(qMin(entry.row, count()), entry.task);
+        entry.task = Task();
+    }
+
+    for (i=0; i<step.entries.count(); i++) {
+        if (step.entries.at(i).kind == going) continue;
+        row = this->row(step.entries.at(i).taskID);
+        if (row < 0) continue;
+        refreshTask(row);
+        rows.append(row);
+    }
+    updateTotals();
+}
+
+
+bool CTaskStore::movesRows(const QList<sUndoStep> &steps) const
+{
+//  Check if undoing/redoing the last of "steps" adds or removes tasks (the views need a reset then)
+    int i;
+
+    if (steps.isEmpty()) return false;
+
+    for (i=0; i<steps.last().entries.count(); i++) {
+        if (steps.last().entries.at(i).kind != TaskChanged) return true;
+    }
+
+    return false;
+}
+
+
+bool CTaskStore::checkDate()
+{
+//  Move on to the current date if a new day has started (this also covers a new month & year)
+//  All tasks are recomputed then - returns true in this case
+    QDate current;
+
+    current = QDate::currentDate();
+    if (current == m_today) return false;
+
+    TRACE_SCOPE("CTaskStore::checkDate: new day");
+    m_today     = current;
+    m_thisMonth = (quint8)  current.month();
+    m_thisYear  = (quint16) current.year();
+    refresh();
+
+    return true;
+}
+
+
+int CTaskStore::tick(qint32 taskID)
+{
+//  Add one second to today's time of the task counting time
+//  Returns the row of the task, -1 if taskID was not found
+    return credit(taskID, m_today, 1);
+}
+
+
+int CTaskStore::credit(qint32 taskID, const QDate &date, quint32 seconds)
+{
+//  Add seconds counted by the running timer (see CTimeEngine) to the time of a task on "date"
+//  The cached times & totals are increased in place - no need to go through the timelog again.
+//  Returns the row of the task, -1 if taskID was not found (e.g. removed in the meantime)
+    int row;
+    TRACE_SCOPE("CTaskStore::credit");
+
+    row = this->row(taskID);
+    if (row < 0) return -1;
+
+    sTime &time = record(row).timelog[date];
+    time = makeTime(time.elapsedSeconds + seconds);
+    m_aggregate.add(m_hot.record.at(row), date, seconds);
+
+    m_hot.seconds[Total][row] += seconds;
+    if (date.year() == m_thisYear) {
+        m_hot.seconds[ThisYear][row] += seconds;
+        m_totals.thisYear = makeTime(m_totals.thisYear.elapsedSeconds + seconds);
+        if (date.month() == m_thisMonth) {
+            m_hot.seconds[ThisMonth][row] += seconds;
+            m_totals.thisMonth = makeTime(m_totals.thisMonth.elapsedSeconds + seconds);
+        }
+    }
+    if (date == m_today) {
+        m_hot.seconds[Today][row] += seconds;
+        m_totals.today = makeTime(m_totals.today.elapsedSeconds + seconds);
+    }
+
+    return row;
+}
+
+
+void CTaskStore::refresh()
+{
+//  Recompute the times of all tasks without increasing them
+//  (Call e.g. after loading a new file to properly initialize all displays)
+    int i;
+    TRACE_SCOPE("CTaskStore::refresh");
+
+    for (i=0; i<count(); i++) {
+        refreshTask(i);
+    }
+    updateTotals();
+}
+
+
+void CTaskStore::refreshTask(int row)
+{
+//  Recompute today's, this month's, this year's and the total time of a task from its timelog
+//  Every task has an entry for today (possibly 0), which is created here if needed.
+//  (Only then the timelog is written to - it stays shared with the copies kept for undo, see commitUndoStep())
+    quint32 month, year, total;
+    QMap<QDate, sTime>::const_iterator it;
+    QMap<QDate, sTime> &timelog = record(row).timelog;
+
+    it = timelog.constFind(m_today);
+    if (it == timelog.constEnd()) it = timelog.insert(m_today, makeTime(0));
+    m_hot.seconds[Today][row] = it.value().elapsedSeconds;
+
+    month = 0;
+    year  = 0;
+    total = 0;
+    // Iterate over all daily entries:
+    for (it = timelog.constBegin(); it != timelog.constEnd(); ++it) {
+        total += it.value().elapsedSeconds;
+        if (it.key().year() == m_thisYear) {
+            year += it.value().elapsedSeconds;
+            if (it.key().month() == m_thisMonth) month += it.value().elapsedSeconds;
+        }
+    }
+    m_hot.seconds[ThisMonth][row] = month;
+    m_hot.seconds[ThisYear][row]  = year;
+    m_hot.seconds[Total][row]     = total;
+}
+
+
+void CTaskStore::updateTotals()
+{
+//  Update total time today / this month / this year (main window)
+    quint32 today, month, year;
+    int i;
+
+    today = 0;
+    month = 0;
+    year  = 0;
+    // The times of each task are up to date (see refreshTask()):
+    for (i=0; i<count(); i++) {
+        today += m_hot.seconds[Today].at(i);
+        month += m_hot.seconds[ThisMonth].at(i);
+        year  += m_hot.seconds[ThisYear].at(i);
+    }
+
+    m_totals.today     = makeTime(today);
+    m_totals.thisMonth = makeTime(month);
+    m_totals.thisYear  = makeTime(year);
+}
+
+
+void CTaskStore::updateDaily(const QDate &date)
+{
+//  Update hours per day for the given day (report window)
+    QVector<quint32> seconds;
+    int i, daysWorked;
+    TRACE_SCOPE("CTaskStore::updateDaily");
+
+    // One column of the matrix of that year:
+    m_totals.secondsDaily = 0;
+    if (date.isValid()) {
+        prepareAggregate(date.year());
+        m_totals.secondsDaily = m_aggregate.sum(date.dayOfYear() - 1, date.dayOfYear() - 1, seconds, daysWorked);
+    }
+
+    for (i=0; i<count(); i++) {
+        m_hot.seconds[Daily][i] = seconds.value(m_hot.record.at(i));
+    }
+}
+
+
+void CTaskStore::updateMonthly(int month, int year)
+{
+//  Update hours per month for the given month (report window)
+//  (month = [1 .. 12])
+    QVector<quint32> seconds;
+    QDate first;
+    int i, daysWorked;
+    TRACE_SCOPE("CTaskStore::updateMonthly");
+
+    // The days of the month in the matrix of that year:
+    first = QDate(year, month, 1);
+    m_totals.secondsMonthly = 0;
+    daysWorked = 0;
+    if (first.isValid()) {
+        prepareAggregate(year);
+        m_totals.secondsMonthly = m_aggregate.sum(first.dayOfYear() - 1, first.dayOfYear() + first.daysInMonth() - 2, seconds, daysWorked);
+    }
+
+    for (i=0; i<count(); i++) {
+        m_hot.seconds[Monthly][i] = seconds.value(m_hot.record.at(i));
+    }
+
+    // Number of days worked this month (on any task):
+    m_totals.daysWorkedMonthly = daysWorked;
+}
+
+
+void CTaskStore::updateYearly(int year)
+{
+//  Update hours per year for the given year (report window)
+    QVector<quint32> seconds;
+    QDate first;
+    int i, daysWorked;
+    TRACE_SCOPE("CTaskStore::updateYearly");
+
+    // All days of the matrix of that year:
+    first = QDate(year, 1, 1);
+    m_totals.secondsYearly = 0;
+    daysWorked = 0;
+    if (first.isValid()) {
+        prepareAggregate(year);
+        m_totals.secondsYearly = m_aggregate.sum(0, first.daysInYear() - 1, seconds, daysWorked);
+    }
+
+    for (i=0; i<count(); i++) {
+        m_hot.seconds[Yearly][i] = seconds.value(m_hot.record.at(i));
+    }
+
+    // Number of days worked this year (on any task):
+    m_totals.daysWorkedYearly = daysWorked;
+}
+
+
+void CTaskStore::fillAggregate(CAggregate &aggregate, int year) const
+{
+//  Fill the matrix of the report sums with the seconds of all tasks in "year" (one row per record, see sRecord)
+    QMap<QDate, sTime>::const_iterator it;
+    QDate first;
+    int i;
+    TRACE_SCOPE("CTaskStore::fillAggregate");
+
+    aggregate.reset(year, m_records.count());
+    first = QDate(year, 1, 1);
+    if (!first.isValid()) return;
+
+    for (i=0; i<count(); i++) {
+        const QMap<QDate, sTime> &timelog = this->timelog(i);
+        for (it = timelog.lowerBound(first); it != timelog.constEnd() && it.key().year() == year; ++it) {
+            aggregate.set(m_hot.record.at(i), it.key(), it.value().elapsedSeconds);
+        }
+    }
+}
+
+
+void CTaskStore::prepareAggregate(int year)
+{
+//  Make sure the matrix of the report sums holds "year" & is up to date
+//  Edits of single days keep it up to date (see setTime() & credit()), others have it filled again here.
+    if (m_aggregateValid && m_aggregate.year() == year) return;
+
+    fillAggregate(m_aggregate, year);
+    m_aggregateValid = true;
+}
+
+
+quint32 CTaskStore::elapsedSeconds(int row, const QDate &from, const QDate &to) const
+{
+//  Time logged on a task from "from" to "to" (both included), in seconds - for reports over any range of days
+    quint32 seconds;
+    QMap<QDate, sTime>::const_iterator it;
+
+    seconds = 0;
+    if (row < 0 || row >= count()) return 0;
+    for (it = timelog(row).lowerBound(from); it != timelog(row).end() && it.key() <= to; ++it) {
+        seconds += it.value().elapsedSeconds;
+    }
+
+    return seconds;
+}
+
+
+bool CTaskStore::lessThan(int a, int b, int column) const
+{
+//  Sort criterion of sort() - only the titles are looked up in the records
+    switch (column) {
+    case 0:  return title(a) < title(b);
+    case 1:  return m_hot.seconds[Today].at(a) < m_hot.seconds[Today].at(b);
+    case 2:  return m_hot.seconds[ThisMonth].at(a) < m_hot.seconds[ThisMonth].at(b);
+    case 3:  return m_hot.seconds[ThisYear].at(a) < m_hot.seconds[ThisYear].at(b);
+    default: return m_hot.seconds[Total].at(a) < m_hot.seconds[Total].at(b);
+    }
+}
+
+
+QVector<int> CTaskStore::sort(int column, Qt::SortOrder order)
+{
+//  Sort the task list (stable, i.e. tasks with equal values keep their order)
+//  column = 0:  Sort by title
+//  column = 1:  Sort by daily elapsed seconds
+//  column = 2:  Sort by monthly elapsed seconds
+//  column = 3:  Sort by yearly elapsed seconds
+//  column = 4:  Sort by total elapsed seconds
+//  Returns the old row of each task in the new order.
+    QVector<int> order_old(count());
+    int i;
+    TRACE_SCOPE("CTaskStore::sort");
+
+    for (i=0; i<order_old.count(); i++) order_old[i] = i;
+    if (column < 0 || column > 4) return order_old;
+
+    std::stable_sort(order_old.begin(), order_old.end(), [this, column, order](int a, int b) {
+        return order == Qt::AscendingOrder ? lessThan(a, b, column) : lessThan(b, a, column);
+    });
+
+    // Only the rows move, the records stay where they are:
+    m_hot.permute(order_old);
+
+    return order_old;
+}
+
+
+void CTaskStore::writeCsv(QTextStream &out) const
+{
+//  Export time data in CSV format: one line per day from the earliest to the latest entry, decimal hours per task
+//  (CCsvImport reads it back; titles with commas, quotes or line feeds are quoted)
+    QDate earliestEntry, latestEntry, DayToWrite;
+    QString title;
+    float decimalHours;
+    int   i;
+    TRACE_SCOPE("CTaskStore::writeCsv");
+
+    out.setNumberFlags(QTextStream::ForcePoint);
+    out.setRealNumberNotation(QTextStream::FixedNotation);
+    out.setRealNumberPrecision(3);
+
+    // Find earliest & latest entry in any of the tasks (the timelog is ordered by date):
+    earliestEntry = m_today;
+    latestEntry.setDate(1970,1,1);
+    for (i=0; i<count(); i++) {
+        if (timelog(i).isEmpty()) continue;
+        if (timelog(i).firstKey() < earliestEntry) earliestEntry = timelog(i).firstKey();
+        if (timelog(i).lastKey()  > latestEntry)   latestEntry   = timelog(i).lastKey();
+    }
+
+    // Write header:
+    out << "Date";
+    for (i=0; i<count(); i++) {
+        title = this->title(i);
+        if (title.contains(',') || title.contains('"') || title.contains('\n') || title.contains('\r')) {
+            title = "\"" + title.replace("\"", "\"\"") + "\"";
+        }
+        out << "," << title;
+    }
+    out << endl;
+
+    // Write entries:
+    for (DayToWrite = earliestEntry; DayToWrite <= latestEntry; DayToWrite = DayToWrite.addDays(1)) {
+        out << DayToWrite.toString("dd.MM.yyyy").toUtf8().data();
+        for (i=0; i<count(); i++) {
+            decimalHours = timelog(i).value(DayToWrite).elapsedSeconds/3600.0;
+            out << "," << decimalHours;
+        }
+        out << endl;
+    }
+}
+
+
+void CTaskStore::checkEntries(int row)
+{
+//  Debug: Print all timelog entries for task in "row" to console
+    QMap<QDate, sTime>::const_iterator it;
+
+    qInfo("Entries for task '%s' (Task ID %d):",title(row).toUtf8().data(),taskID(row));
+    logger.info() << "Entries for task " << title(row) << " (Task ID " << taskID(row) << "):";
+
+    // Iterate over all daily entries:
+    for (it = timelog(row).constBegin(); it != timelog(row).constEnd(); ++it) {
+        qInfo("Date: %s   Time logged: %02d:%02d:%02d",it.key().toString("dd.MM.yyyy").toUtf8().data(),it.value().Hours,it.value().Minutes,it.value().Seconds);
+        logger.info() << "Date: " << it.key().toString("dd.MM.yyyy") << " Time logged: " << it.value().Hours << ":" << it.value().Minutes << ":"<< it.value().Seconds;
+    }
+}
+
+
+void CTaskStore::memoryUsage(quint64 &hot, quint64 &cold, quint64 &timelogs) const
+{
+//  Estimate the memory used by the tasks, in bytes (container capacity, strings & timelog nodes; no allocator overhead)
+//  hot: the arrays indexed by row, cold: the records incl. titles & descriptions, timelogs: the timelog entries
+    int i;
+
+    hot = m_hot.taskID.capacity() * sizeof(quint32) + m_hot.active.capacity() * sizeof(quint8) +
+          m_hot.allocate.capacity() * sizeof(quint8) + m_hot.record.capacity() * sizeof(int);
+    for (i=0; i<Periods; i++) hot += m_hot.seconds[i].capacity() * sizeof(quint32);
+
+    cold     = m_records.capacity() * sizeof(sRecord) + m_freeRecords.capacity() * sizeof(int);
+    timelogs = 0;
+    for (i=0; i<m_records.count(); i++) {
+        cold     += (m_records.at(i).title.capacity() + m_records.at(i).description.capacity()) * sizeof(QChar);
+        timelogs += m_records.at(i).timelog.size() * (sizeof(QDate) + sizeof(sTime) + 3 * sizeof(void*));
+    }
+}
+
+
+CTaskStore::Task CTaskStore::task(int row) const
+{
+//  Put a task together from its parts, e.g. for saving it
+    return makeTask(m_hot, m_records, row);
+}
+
+
+CTaskStore::Task CTaskStore::makeTask(const sHot &hot, const QVector<sRecord> &records, int row)
+{
+//  Put together the task in "row" of "hot" (the store or the copy of an undo step)
+    Task task;
+    const sRecord &record = records.at(hot.record.at(row));
+
+    task.title         = record.title;
+    task.description   = record.description;
+    task.taskID        = hot.taskID.at(row);
+    task.taskActive    = hot.active.at(row);
+    task.allocateTime  = hot.allocate.at(row);
+    task.timeTotal     = makeTime(hot.seconds[Total].at(row));
+    task.timeToday     = makeTime(hot.seconds[Today].at(row));
+    task.timeThisMonth = makeTime(hot.seconds[ThisMonth].at(row));
+    task.timeThisYear  = makeTime(hot.seconds[ThisYear].at(row));
+    task.timeDaily     = makeTime(hot.seconds[Daily].at(row));
+    task.timeMonthly   = makeTime(hot.seconds[Monthly].at(row));
+    task.timeYearly    = makeTime(hot.seconds[Yearly].at(row));
+    task.timeTodayString     = timeString(task.timeToday);
+    task.timeThisMonthString = timeString(task.timeThisMonth);
+    task.timeThisYearString  = timeString(task.timeThisYear);
+    task.timeDailyString     = timeString(task.timeDaily);
+    task.timeMonthlyString   = timeString(task.timeMonthly);
+    task.timeYearlyString    = timeString(task.timeYearly);
+    task.timelog       = record.timelog;
+
+    return task;
+}
+
+
+int CTaskStore::insertTask(int row, const Task &task)
+{
+//  Insert a task at "row" - not counting time, not marked for allocation, its times still to be computed (see refreshTask())
+    m_hot.insert(row, task.taskID, newRecord({ task.title, task.description, task.timelog }));
+    return row;
+}
+
+
+int CTaskStore::newRecord(const sRecord &record)
+{
+//  Store the cold data of a new task, in the slot of a task removed if there is one
+//  Returns the index of the record
+    int index;
+
+    m_aggregateValid = false;
+
+    if (m_freeRecords.isEmpty()) {
+        m_records.append(record);
+        return m_records.count() - 1;
+    }
+
+    index = m_freeRecords.takeLast();
+    m_records[index] = record;
+    return index;
+}
+
+
+void CTaskStore::removeRow(int row)
+{
+//  Remove the task in "row", its record slot is freed for the next task
+    m_aggregateValid = false;
+    m_records[m_hot.record.at(row)] = sRecord();
+    m_freeRecords.append(m_hot.record.at(row));
+    m_hot.remove(row);
+}
+
+
+void CTaskStore::sHot::insert(int row, quint32 id, int rec)
+{
+//  Insert a row into all arrays (times 0, flags cleared)
+    int i;
+
+    taskID.insert(row, id);
+    active.insert(row, 0);
+    allocate.insert(row, 0);
+    for (i=0; i<Periods; i++) seconds[i].insert(row, 0);
+    record.insert(row, rec);
+}
+
+
+void CTaskStore::sHot::remove(int row)
+{
+//  Remove a row from all arrays
+    int i;
+
+    taskID.remove(row);
+    active.remove(row);
+    allocate.remove(row);
+    for (i=0; i<Periods; i++) seconds[i].remove(row);
+    record.remove(row);
+}
+
+
+void CTaskStore::sHot::permute(const QVector<int> &order)
+{
+//  Reorder the rows: new row i is old row order[i]
+    sHot old = *this;
+    int i, n;
+
+    for (i=0; i<order.count(); i++) {
+        taskID[i]   = old.taskID.at(order.at(i));
+        active[i]   = old.active.at(order.at(i));
+        allocate[i] = old.allocate.at(order.at(i));
+        for (n=0; n<Periods; n++) seconds[n][i] = old.seconds[n].at(order.at(i));
+        record[i]   = old.record.at(order.at(i));
+    }
+}
+
+
+void CTaskStore::sHot::clear()
+{
+//  Remove all rows
+    int i;
+
+    taskID.clear();
+    active.clear();
+    allocate.clear();
+    for (i=0; i<Periods; i++) seconds[i].clear();
+    record.clear();
+}
+
+
+CTaskStore::sTime CTaskStore::makeTime(quint32 seconds)
+{
+//  Split a no. of seconds into hours, minutes & seconds
+    sTime time;
+
+    time.elapsedSeconds = seconds;
+    time.Hours   =  seconds / 3600;
+    time.Minutes = (seconds - time.Hours*3600) / 60;
+    time.Seconds =  seconds - (time.Hours*3600 + time.Minutes*60);
+
+    return time;
+}
+
+
+QString CTaskStore::timeString(const sTime &time)
+{
+//  Format a time for display (hh:mm:ss)
+    return QString("%1:%2:%3").arg(time.Hours,2,10,QLatin1Char('0')).arg(time.Minutes,2,10,QLatin1Char('0')).arg(time.Seconds,2,10,QLatin1Char('0'));
+}
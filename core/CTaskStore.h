@@ -0,0 +1,252 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CTASKSTORE_H
+#define CTASKSTORE_H
+
+#include <QString>
+#include <QList>
+#include <QStringList>
+#include <QVector>
+#include <QMap>
+#include <QSet>
+#include <QDate>
+#include <QTextStream>
+#include "CLogger.h"
+#include "CAggregate.h"
+
+#define UNDO_LEVELS 50   // Max. no. of steps that can be undone
+
+
+// The tasks and their timelogs, with the times derived from them (today, this month, this year, total & report periods).
+//
+// Part of the core library (see core.pri): QtCore only, no signals - CTaskModel presents the store to QML and tells the
+// views which rows changed, CHeadless and CModelBenchmark use it directly. Not thread-safe: one thread owns the store.
+// The cached times of a task always refer to the date of the store (see checkDate()), they are recomputed from the
+// timelog by every function changing it.
+// The tasks are kept as structure of arrays: ID, flags & cached seconds in one contiguous array each, indexed by row;
+// title, description & timelog in a record the row points to. Ticks, totals & sorts only touch the arrays.
+class CTaskStore
+{
+public:
+    struct sTime {
+        quint16 Hours;
+        quint16 Minutes;
+        quint16 Seconds;
+        quint32 elapsedSeconds;
+    };
+
+    // A complete task, as loaded & saved (see task() & setTasks()) - the store itself keeps its parts apart:
+    struct Task {
+        QString title;
+        QString description;
+        quint32 taskID;
+        quint8  taskActive;           // 1 if this task is currently counting time
+        quint8  allocateTime;         // 1 if this task is a target for reallocation
+        sTime   timeTotal;            // Total time logged on task
+        sTime   timeToday;            // Time logged on task today
+        QString timeTodayString;      // String to display time logged on task today
+        sTime   timeThisMonth;        // Time logged on task this month
+        QString timeThisMonthString;  // String to display time logged on task this month
+        sTime   timeThisYear;         // Time logged on task this year
+        QString timeThisYearString;   // String to display time logged on task this year
+        sTime   timeDaily;            // Time logged on task per day (for report window; only ever holds the last day queried by the HMI)
+        QString timeDailyString;      // String to display time logged on task per day
+        sTime   timeMonthly;          // Time logged on task per month (for report window; only ever holds the last month queried by the HMI)
+        QString timeMonthlyString;    // String to display time logged on task per month
+        sTime   timeYearly;           // Time logged on task per year (for report window; only ever holds the last year queried by the HMI)
+        QString timeYearlyString;     // String to display time logged on task per year
+        QMap<QDate, sTime> timelog;   // Map between date and time logged per day
+    };
+
+    // Time summed up over all tasks
+    struct sTotals {
+        sTime   today;               // Main window
+        sTime   thisMonth;
+        sTime   thisYear;
+        quint32 secondsDaily;        // Report window (last day/month/year queried)
+        quint32 secondsMonthly;
+        quint32 secondsYearly;
+        quint16 daysWorkedMonthly;
+        quint16 daysWorkedYearly;
+    };
+
+    // Times cached per task (in seconds, see refreshTask() and updateDaily()/updateMonthly()/updateYearly()):
+    enum ePeriod { Today, ThisMonth, ThisYear, Total, Daily, Monthly, Yearly, Periods };
+
+    CTaskStore(CLogger &logger);
+
+    int  count() const { return m_hot.taskID.count(); }
+    quint32 taskID(int row) const   { return m_hot.taskID.at(row); }
+    quint8  active(int row) const   { return m_hot.active.at(row); }
+    quint8  allocate(int row) const { return m_hot.allocate.at(row); }
+    quint32 seconds(int row, ePeriod period) const { return m_hot.seconds[period].at(row); }
+    sTime   time(int row, ePeriod period) const    { return makeTime(m_hot.seconds[period].at(row)); }
+    const QString &title(int row) const       { return m_records.at(m_hot.record.at(row)).title; }
+    const QString &description(int row) const { return m_records.at(m_hot.record.at(row)).description; }
+    const QMap<QDate, sTime> &timelog(int row) const { return m_records.at(m_hot.record.at(row)).timelog; }
+    Task task(int row) const;
+    const sTotals &totals() const { return m_totals; }
+    const QDate &today() const { return m_today; }
+    quint8  thisMonth() const { return m_thisMonth; }
+    quint16 thisYear() const { return m_thisYear; }
+    int  row(qint32 taskID) const;
+
+    // Editing
+    void setTasks(const QList<Task> &tasks);
+    int  append(const QString &title, const QString &description);
+    void set(int row, const QString &title, const QString &description);
+    void setTime(int row, const QDate &date, const sTime &time);
+    void addTime(int row, const QDate &date, int seconds);
+    void setActive(int row, quint8 active);
+    void setAllocate(int row, quint8 allocate);
+    void resetAllocate();
+    bool reallocate(int row, const QDate &date, bool weighted);
+    bool reallocateAll(int row, bool weighted);
+    bool reallocateRange(int row, const QDate &from, const QDate &to, bool weighted);
+    void resetToday(int row);
+    void resetTotal(int row);
+    void remove(int row);
+    void clear();
+    int  importTimes(const QStringList &titles, const QVector<QMap<QDate, quint32>> &times);
+
+    // Batches: timelog edits between beginBatch() and commitBatch() only mark their tasks, commitBatch() recomputes
+    // each of them once (batches nest, the outermost commit does the work)
+    void beginBatch();
+    void commitBatch();
+    bool inBatch() const { return m_batchDepth > 0; }
+
+    // Undo: the edits between beginUndoStep() and commitUndoStep() are undone & redone together (steps nest like batches).
+    // A step keeps only the days it changed; undo & redo apply the difference, so time counted since the step stays.
+    void beginUndoStep(const QString &label);
+    void commitUndoStep();
+    bool undo(QVector<int> &rows);
+    bool redo(QVector<int> &rows);
+    void clearUndo();
+    bool inUndoStep() const { return m_undoDepth > 0; }
+    bool undoMovesRows() const { return movesRows(m_undo); }
+    bool redoMovesRows() const { return movesRows(m_redo); }
+    QString undoLabel() const { return m_undo.isEmpty() ? QString() : m_undo.last().label; }
+    QString redoLabel() const { return m_redo.isEmpty() ? QString() : m_redo.last().label; }
+
+    // Timekeeping
+    bool checkDate();
+    int  tick(qint32 taskID);
+    int  credit(qint32 taskID, const QDate &date, quint32 seconds);
+    void refresh();
+    void refreshTask(int row);
+
+    // Aggregation
+    void updateTotals();
+    void updateDaily(const QDate &date);
+    void updateMonthly(int month, int year);
+    void updateYearly(int year);
+    void fillAggregate(CAggregate &aggregate, int year) const;
+    quint32 elapsedSeconds(int row, const QDate &from, const QDate &to) const;
+    QVector<int> sort(int column, Qt::SortOrder order);
+    void writeCsv(QTextStream &out) const;
+    void checkEntries(int row);   // Debug: Print all timelog entries for one task
+    void memoryUsage(quint64 &hot, quint64 &cold, quint64 &timelogs) const;
+
+    static sTime   makeTime(quint32 seconds);
+    static QString timeString(const sTime &time);
+    static void    apportion(quint32 amount, const QVector<quint32> &weights, QVector<quint32> &shares);
+
+private:
+    // The hot data: one entry per row in each array
+    struct sHot {
+        QVector<quint32> taskID;
+        QVector<quint8>  active;             // 1 if this task is currently counting time
+        QVector<quint8>  allocate;           // 1 if this task is a target for reallocation
+        QVector<quint32> seconds[Periods];   // Cached times (Daily/Monthly/Yearly: last report queried by the HMI)
+        QVector<int>     record;             // Index of the cold data in m_records
+
+        void insert(int row, quint32 id, int rec);
+        void remove(int row);
+        void permute(const QVector<int> &order);
+        void clear();
+    };
+
+    // The cold data of a task - never moved by sorting or removing rows
+    struct sRecord {
+        QString title;
+        QString description;
+        QMap<QDate, sTime> timelog;   // Map between date and time logged per day
+    };
+
+    // One timelog entry to set by a reallocation (see planReallocation())
+    struct sTransfer {
+        int     row;
+        QDate   date;
+        quint32 seconds;
+    };
+
+    // One day of a timelog changed by an undo step: the seconds logged before & after the step (-1: no entry)
+    struct sDayChange {
+        QDate   date;
+        qint64  before;
+        qint64  after;
+    };
+
+    // One task changed, added or removed by an undo step - a task added or removed is kept whole while it is not in the store
+    enum eUndoKind { TaskChanged, TaskAdded, TaskRemoved };
+    struct sUndoEntry {
+        quint32   taskID;
+        int       row;                  // Added/Removed: row the task is taken from & put back to
+        eUndoKind kind;
+        QString   title[2];             // Changed: before & after the step
+        QString   description[2];
+        QVector<sDayChange> days;       // Changed: the days edited
+        Task      task;                 // Added/Removed: the task while it is not in the store
+    };
+
+    struct sUndoStep {
+        QString label;
+        QVector<sUndoEntry> entries;
+    };
+
+    bool planReallocation(int row, const QDate &from, const QDate &to, bool weighted, QVector<sTransfer> &plan) const;
+    void applyStep(sUndoStep &step, bool redo, QVector<int> &rows);
+    static void diffTimelogs(const QMap<QDate, sTime> &before, const QMap<QDate, sTime> &after, QVector<sDayChange> &days);
+    bool movesRows(const QList<sUndoStep> &steps) const;
+    int  insertTask(int row, const Task &task);
+    int  newRecord(const sRecord &record);
+    void removeRow(int row);
+    sRecord &record(int row) { return m_records[m_hot.record.at(row)]; }
+    static Task makeTask(const sHot &hot, const QVector<sRecord> &records, int row);
+    void prepareAggregate(int year);
+
+    sHot        m_hot;
+    QVector<sRecord> m_records;
+    QVector<int> m_freeRecords;   // Slots in m_records not used by any row
+    CAggregate  m_aggregate;      // Seconds per record & day of the year last reported on (see prepareAggregate())
+    bool        m_aggregateValid;
+    sTotals     m_totals;
+    QDate       m_today;      // Date the cached times refer to
+    quint8      m_thisMonth;
+    quint16     m_thisYear;
+    int         m_batchDepth;
+    QSet<quint32> m_batchTasks;   // IDs of the tasks edited in the current batch
+    QList<sUndoStep> m_undo;      // Oldest step first
+    QList<sUndoStep> m_redo;
+    sHot        m_undoHot;        // The tasks at beginUndoStep()
+    QVector<sRecord> m_undoRecords;
+    int         m_undoDepth;
+    QString     m_undoLabel;
+    CLogger     &logger;
+
+    bool lessThan(int a, int b, int column) const;
+};
+
+#endif // CTASKSTORE_H
@@ -0,0 +1,205 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <QTime>
+#include "CTimeEngine.h"
+#include "CTrace.h"
+
+
+CTimeEngine::CTimeEngine()
+{
+    current.taskID     = -1;
+    current.day        = 0;
+    current.runSeconds = 0;
+    current.processed  = 0;
+    current.queued     = 0;
+    state.store(current);
+
+    issued   = 0;
+    running  = false;
+    runStart = 0;
+    counted  = 0;
+    clock.start();
+}
+
+
+CTimeEngine::~CTimeEngine()
+{
+    close();
+}
+
+
+void CTimeEngine::open()
+{
+//  Start the engine thread
+    if (running) return;
+
+    running = true;
+    start(QThread::HighPriority);
+}
+
+
+void CTimeEngine::close()
+{
+//  Stop the engine thread (credits not taken by then are lost - call flush() and take them first)
+    if (!running) return;
+
+    while (!send(Quit, -1)) QThread::msleep(1);
+    wait();
+    running = false;
+}
+
+
+bool CTimeEngine::startTask(qint32 taskID)
+{
+//  Start counting time on taskID (from now on - the task running so far is stopped at the same moment)
+//  Returns false if the command queue is full
+    return send(Start, taskID);
+}
+
+
+bool CTimeEngine::stopTask()
+{
+//  Stop counting time (as of now)
+//  Returns false if the command queue is full
+    return send(Stop, -1);
+}
+
+
+bool CTimeEngine::flush(int timeout)
+{
+//  Wait until the engine has processed all commands sent so far & queued their credits (at most timeout ms)
+//  Returns false on timeout or if the engine is not running
+    QElapsedTimer waited;
+
+    if (!running) return false;
+
+    waited.start();
+    while (state.load().processed != issued) {
+        if (waited.elapsed() >= timeout) return false;
+        QThread::yieldCurrentThread();
+    }
+    return true;
+}
+
+
+bool CTimeEngine::send(Command type, qint32 taskID)
+{
+//  Queue a command, time stamped now
+    sCommand command;
+
+    command.type   = type;
+    command.taskID = taskID;
+    command.stamp  = clock.elapsed();
+    if (!commands.push(command)) return false;
+
+    issued++;
+    wake.release();
+    return true;
+}
+
+
+void CTimeEngine::run()
+{
+//  Engine thread: take the commands, count the running task up to now, hand out the credits & publish the new state
+//  Wakes up at every full second of the running task, for every command and to retry credits that did not fit
+    sCommand command;
+    qint64  stamp;
+    int     timeout;
+    bool    quit;
+
+    quit = false;
+    while (!quit) {
+        if (current.taskID >= 0)    timeout = 1000 - (int) ((clock.elapsed() - runStart) % 1000);
+        else if (!pending.isEmpty()) timeout = 1000;
+        else                         timeout = -1;
+        wake.tryAcquire(1, timeout);
+
+        TRACE_SCOPE("CTimeEngine::step");
+        while (commands.pop(command)) {
+            // A command issued while the last step was running takes effect when that step counted up to:
+            stamp = qMax(command.stamp, counted);
+            count(stamp);
+            switch (command.type) {
+            case Start:
+                current.taskID     = command.taskID;
+                current.runSeconds = 0;
+                runStart = stamp;
+                runDay   = QDate::currentDate();
+                current.day = runDay.toJulianDay();
+                break;
+            case Stop:
+                current.taskID     = -1;
+                current.runSeconds = 0;
+                break;
+            case Quit:
+                quit = true;
+                break;
+            }
+            current.processed++;
+        }
+        count(qMax(clock.elapsed(), counted));
+
+        while (!pending.isEmpty() && credits.push(pending.first())) {
+            current.queued += pending.first().seconds;
+            pending.removeFirst();
+        }
+        state.store(current);
+    }
+}
+
+
+void CTimeEngine::count(qint64 now)
+{
+//  Credit the whole seconds the running task has counted up to "now" (ms on clock)
+    QDate   today;
+    quint32 total, seconds, after;
+
+    counted = now;
+    if (current.taskID < 0) return;
+
+    total = (quint32) ((now - runStart) / 1000);
+    if (total <= current.runSeconds) return;
+    seconds = total - current.runSeconds;
+    current.runSeconds = total;
+
+    // Seconds after midnight belong to the new day:
+    today = QDate::currentDate();
+    if (today != runDay) {
+        after = qMin(seconds, (quint32) (QTime::currentTime().msecsSinceStartOfDay() / 1000));
+        credit(current.taskID, runDay, seconds - after);
+        seconds = after;
+        runDay  = today;
+        current.day = today.toJulianDay();
+    }
+    credit(current.taskID, runDay, seconds);
+}
+
+
+void CTimeEngine::credit(qint32 taskID, const QDate &day, quint32 seconds)
+{
+//  Add seconds to the credits waiting for the queue (one entry per task & day)
+    sCredit entry;
+
+    if (seconds == 0) return;
+
+    if (!pending.isEmpty() && pending.last().taskID == taskID && pending.last().day == day.toJulianDay()) {
+        pending.last().seconds += seconds;
+        return;
+    }
+    entry.taskID  = taskID;
+    entry.day     = day.toJulianDay();
+    entry.seconds = seconds;
+    pending.append(entry);
+}
@@ -0,0 +1,102 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CTIMEENGINE_H
+#define CTIMEENGINE_H
+
+#include <QThread>
+#include <QSemaphore>
+#include <QElapsedTimer>
+#include <QDate>
+#include <QVector>
+#include "CLockFree.h"
+
+// Commands the engine has not taken yet - further commands fail while the queue is full
+#define ENGINE_COMMAND_QUEUE  64
+// Credits the owner of the task store has not taken yet - the engine keeps adding up further time meanwhile
+#define ENGINE_CREDIT_QUEUE   1024
+
+
+// Running timer on its own thread
+//
+// The engine measures the time of the running task on a monotonic clock and hands it out as credits (task, day, seconds),
+// so neither a busy GUI thread nor a late timer changes the time recorded. The owner of the task store sends commands
+// (start / stop, time stamped when they are issued) and takes the credits whenever it gets to it, see CTaskModel::Update().
+// Both directions are lock-free single-producer / single-consumer queues; the state of the engine is published as a
+// snapshot that any thread may read without waiting (e.g. at display rate). The engine never waits for its owner.
+class CTimeEngine : public QThread
+{
+public:
+    // Time of one task on one day, not yet added to the store
+    struct sCredit {
+        qint32  taskID;
+        qint64  day;          // Julian day
+        quint32 seconds;
+    };
+
+    // State of the engine as of its last step
+    struct sSnapshot {
+        qint32  taskID;       // Running task, -1 if none
+        qint64  day;          // Julian day the running task is counting on
+        quint32 runSeconds;   // Seconds counted since the task was started
+        quint32 processed;    // Commands processed so far
+        quint64 queued;       // Seconds put into the credit queue so far (a change tells that credits are waiting)
+    };
+
+    CTimeEngine();
+    ~CTimeEngine();
+
+    void open();
+    void close();
+
+    // Owner only:
+    bool startTask(qint32 taskID);
+    bool stopTask();
+    bool flush(int timeout = 100);
+    bool takeCredit(sCredit &credit) { return credits.pop(credit); }
+
+    sSnapshot snapshot() const { return state.load(); }
+
+protected:
+    void run() override;
+
+private:
+    enum Command { Start, Stop, Quit };
+    struct sCommand {
+        Command type;
+        qint32  taskID;
+        qint64  stamp;        // ms on clock when the command was issued
+    };
+
+    CSpscQueue<sCommand, ENGINE_COMMAND_QUEUE> commands;
+    CSpscQueue<sCredit, ENGINE_CREDIT_QUEUE>   credits;
+    CSeqLock<sSnapshot> state;
+    QSemaphore    wake;       // Released for every command, so the engine takes it at once
+    QElapsedTimer clock;      // Monotonic, shared by both threads (read only)
+    quint32       issued;     // Commands sent so far (owner thread)
+    bool          running;    // Thread started (owner thread)
+
+    // Engine thread only:
+    QVector<sCredit> pending; // Credits that did not fit into the queue yet
+    sSnapshot     current;
+    qint64        runStart;   // ms on clock when the running task was started
+    qint64        counted;    // ms on clock the running task has been counted up to
+    QDate         runDay;     // Day the last seconds were credited to
+
+    bool send(Command type, qint32 taskID);
+    void count(qint64 now);
+    void credit(qint32 taskID, const QDate &day, quint32 seconds);
+};
+
+#endif // CTIMEENGINE_H
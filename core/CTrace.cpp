@@ -0,0 +1,108 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <QFile>
+#include <QTextStream>
+#include "CTrace.h"
+
+CTrace::sEvent          CTrace::events[TRACE_BUFFER_SIZE];
+QAtomicInteger<quint64> CTrace::head;
+QAtomicInt              CTrace::active;
+QAtomicInt              CTrace::threads;
+QElapsedTimer           CTrace::clock;
+QString                 CTrace::traceFile;
+
+
+void CTrace::enable(const QString &file)
+{
+//  Start recording - dump() without a file name writes to "file"
+//  Call once at startup, before any other thread is running
+    traceFile = file;
+    clock.start();
+    threadNo();   // The calling thread is no. 1
+    active.store(1);
+}
+
+
+quint32 CTrace::threadNo()
+{
+//  Small, stable no. of the calling thread (1: the thread that called enable(), i.e. the GUI thread)
+    static thread_local quint32 no = 0;
+
+    if (no == 0) no = (quint32) threads.fetchAndAddRelaxed(1) + 1;
+
+    return no;
+}
+
+
+void CTrace::record(const char *name, qint64 start, qint64 end)
+{
+//  Record a completed span (thread-safe, lock-free)
+    quint64 n;
+    sEvent *event;
+
+    n = head.fetchAndAddRelaxed(1);
+    event = &events[n & (TRACE_BUFFER_SIZE - 1)];
+
+    event->seq.storeRelease(0);
+    event->name     = name;
+    event->start    = start;
+    event->duration = end - start;
+    event->thread   = threadNo();
+    event->seq.storeRelease(n + 1);
+}
+
+
+bool CTrace::dump(const QString &file)
+{
+//  Write the events in the ring buffer as Chrome trace-event JSON ("X" events, times in µs)
+//  Recording continues while dumping; events being written at the time are left out.
+    QFile   out;
+    quint64 n, first, last, seq;
+    const char *name;
+    qint64  start, duration;
+    quint32 thread;
+
+    if (!enabled()) return false;
+
+    out.setFileName(file.isEmpty() ? traceFile : file);
+    if (out.fileName().isEmpty() || !out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning("CTrace::dump(): Could not write trace file %s!", out.fileName().toUtf8().data());
+        return false;
+    }
+    QTextStream json(&out);
+
+    last  = head.loadAcquire();
+    first = last > TRACE_BUFFER_SIZE ? last - TRACE_BUFFER_SIZE : 0;
+
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    json << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"GUI\"}}";
+    for (n = first; n < last; n++) {
+        const sEvent &slot = events[n & (TRACE_BUFFER_SIZE - 1)];
+        seq = slot.seq.loadAcquire();
+        if (seq != n + 1) continue;
+        name     = slot.name;
+        start    = slot.start;
+        duration = slot.duration;
+        thread   = slot.thread;
+        if (slot.seq.loadAcquire() != seq) continue;   // Overwritten while copying
+
+        json << ",\n{\"name\":\"" << name << "\",\"cat\":\"timekeeper\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+             << ",\"ts\":" << QString::number(start / 1000.0, 'f', 3) << ",\"dur\":" << QString::number(duration / 1000.0, 'f', 3) << "}";
+    }
+    json << "\n]}\n";
+    json.flush();
+
+    return out.error() == QFile::NoError;
+}
@@ -0,0 +1,83 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CTRACE_H
+#define CTRACE_H
+
+#include <QString>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+
+// Events kept in the ring buffer (power of 2) - the oldest ones are overwritten
+#define TRACE_BUFFER_SIZE  65536
+
+
+// Scoped trace spans, recorded to a lock-free ring buffer and written as Chrome trace-event JSON
+// (open in chrome://tracing or https://ui.perfetto.dev).
+//
+// Tracing is off unless enabled with "--trace <file>" or the TIMEKEEPER_TRACE environment variable (see main.cpp).
+// A disabled span costs one relaxed load of a flag; defining TIMEKEEPER_NO_TRACE removes the spans completely.
+// Any thread may record: a writer claims a slot with a single atomic increment and publishes it with a sequence number,
+// dump() skips slots that are being written at that moment. Span names must be string literals (only the pointer is stored).
+class CTrace
+{
+public:
+    static void enable(const QString &file);
+    static bool enabled() { return active.load() != 0; }
+    static qint64 now() { return clock.nsecsElapsed(); }
+    static void record(const char *name, qint64 start, qint64 end);
+    static bool dump(const QString &file = QString());
+
+private:
+    struct sEvent {
+        QAtomicInteger<quint64> seq;   // 0: being written, otherwise no. of the event + 1
+        const char *name;
+        qint64  start;                 // ns since enable()
+        qint64  duration;              // ns
+        quint32 thread;
+    };
+    static sEvent events[TRACE_BUFFER_SIZE];
+    static QAtomicInteger<quint64> head;   // No. of events recorded so far
+    static QAtomicInt     active;
+    static QAtomicInt     threads;         // Thread numbers handed out so far
+    static QElapsedTimer  clock;
+    static QString        traceFile;
+
+    static quint32 threadNo();
+};
+
+
+class CTraceScope
+{
+public:
+    explicit CTraceScope(const char *spanName) : name(CTrace::enabled() ? spanName : nullptr), start(name ? CTrace::now() : 0) {}
+    ~CTraceScope() { end(); }
+    // Close the span before the end of the scope
+    void end() { if (name) { CTrace::record(name, start, CTrace::now()); name = nullptr; } }
+
+private:
+    const char *name;
+    qint64 start;
+};
+
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b)  TRACE_CONCAT_(a, b)
+#if defined(TIMEKEEPER_NO_TRACE)
+#define TRACE_SCOPE(name)
+#else
+#define TRACE_SCOPE(name)   CTraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#endif
+
+#endif // CTRACE_H
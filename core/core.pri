@@ -0,0 +1,26 @@
+# Timekeeper core: task store, time engine, save files & encryption, CSV import, logging and tracing.
+# Needs QtCore & QtConcurrent only - no GUI, so it can be used by headless tools as well.
+QT += concurrent
+
+include($$PWD/../crypto/crypto.pri)
+
+SOURCES += \
+    $$PWD/CAggregate.cpp \
+    $$PWD/CCsvImport.cpp \
+    $$PWD/CLogger.cpp \
+    $$PWD/CSaveFile.cpp \
+    $$PWD/CTaskStore.cpp \
+    $$PWD/CTimeEngine.cpp \
+    $$PWD/CTrace.cpp
+
+HEADERS += \
+    $$PWD/CAggregate.h \
+    $$PWD/CCsvImport.h \
+    $$PWD/CLockFree.h \
+    $$PWD/CLogger.h \
+    $$PWD/CSaveFile.h \
+    $$PWD/CTaskStore.h \
+    $$PWD/CTimeEngine.h \
+    $$PWD/CTrace.h
+
+INCLUDEPATH += $$PWD/..
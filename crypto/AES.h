@@ -110,8 +110,17 @@ public:
 
     bool setKey(const uint8_t *key, size_t len);
 
+    void encryptBlock(uint8_t *output, const uint8_t *input);
+    void decryptBlock(uint8_t *output, const uint8_t *input);
+    void encryptBlocks(uint8_t *output, const uint8_t *input, size_t count);
+    void decryptBlocks(uint8_t *output, const uint8_t *input, size_t count);
+
+    void clear();
+
 private:
     uint8_t sched[240];
+    uint8_t inverse[240];   // AES-NI only: schedule of the equivalent inverse cipher
+    bool accel;             // Use AES-NI (selected at runtime)
 };
 
 class AESTiny256 : public BlockCipher
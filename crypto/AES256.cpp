@@ -21,6 +21,7 @@
  */
 
 #include "AES.h"
+#include "AESNI.h"
 #include "Crypto.h"
 #include <string.h>
 
@@ -43,11 +44,13 @@ AES256::AES256()
 {
     rounds = 14;
     schedule = sched;
+    accel = aesni_available();
 }
 
 AES256::~AES256()
 {
     clean(sched);
+    clean(inverse);
 }
 
 /**
@@ -64,6 +67,13 @@ bool AES256::setKey(const uint8_t *key, size_t len)
     if (len != 32)
         return false;
 
+    // With AES-NI, expand the key in hardware and prepare the decryption schedule as well.
+    if (accel) {
+        aesni_expand_key256(sched, key);
+        aesni_inverse_schedule(inverse, sched, 14);
+        return true;
+    }
+
     // Copy the key itself into the first 32 bytes of the schedule.
     uint8_t *schedule = sched;
     memcpy(schedule, key, 32);
@@ -106,6 +116,81 @@ bool AES256::setKey(const uint8_t *key, size_t len)
     return true;
 }
 
+/**
+ * \brief Encrypts a single block using this cipher.
+ *
+ * Uses the AES-NI instructions if the CPU supports them, the portable
+ * AESCommon implementation otherwise.
+ */
+void AES256::encryptBlock(uint8_t *output, const uint8_t *input)
+{
+    if (accel)
+        aesni_encrypt_block(sched, 14, output, input);
+    else
+        AESCommon::encryptBlock(output, input);
+}
+
+/**
+ * \brief Decrypts a single block using this cipher.
+ *
+ * Uses the AES-NI instructions if the CPU supports them, the portable
+ * AESCommon implementation otherwise.
+ */
+void AES256::decryptBlock(uint8_t *output, const uint8_t *input)
+{
+    if (accel)
+        aesni_decrypt_block(inverse, 14, output, input);
+    else
+        AESCommon::decryptBlock(output, input);
+}
+
+/**
+ * \brief Encrypts several independent blocks using this cipher.
+ *
+ * Same approach as decryptBlocks(): eight blocks side by side with AES-NI,
+ * AESCommon::encryptBlock() without a virtual call per block otherwise.
+ */
+void AES256::encryptBlocks(uint8_t *output, const uint8_t *input, size_t count)
+{
+    if (accel) {
+        aesni_encrypt_blocks(sched, 14, output, input, count);
+        return;
+    }
+    while (count > 0) {
+        AESCommon::encryptBlock(output, input);
+        output += 16;
+        input += 16;
+        --count;
+    }
+}
+
+/**
+ * \brief Decrypts several independent blocks using this cipher.
+ *
+ * With AES-NI, eight blocks are decrypted side by side so the pipelined
+ * AES instructions are kept busy. The portable path calls
+ * AESCommon::decryptBlock() directly, without a virtual call per block.
+ */
+void AES256::decryptBlocks(uint8_t *output, const uint8_t *input, size_t count)
+{
+    if (accel) {
+        aesni_decrypt_blocks(inverse, 14, output, input, count);
+        return;
+    }
+    while (count > 0) {
+        AESCommon::decryptBlock(output, input);
+        output += 16;
+        input += 16;
+        --count;
+    }
+}
+
+void AES256::clear()
+{
+    AESCommon::clear();
+    clean(inverse);
+}
+
 /**
  * \class AESTiny256 AES.h <AES.h>
  * \brief AES block cipher with 256-bit keys and tiny memory usage.
@@ -22,7 +22,7 @@
 
 #include "AES.h"
 #include "Crypto.h"
-#include "utility/ProgMemUtil.h"
+#include "utility/Intrinsics.h"
 
 #if defined(CRYPTO_AES_DEFAULT) || defined(CRYPTO_DOC)
 
@@ -48,7 +48,7 @@
 /** @cond sbox */
 
 // AES S-box (http://en.wikipedia.org/wiki/Rijndael_S-box)
-static uint8_t const sbox[256] PROGMEM = {
+static uint8_t const sbox[256] = {
     0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5,     // 0x00
     0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
     0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0,     // 0x10
@@ -84,7 +84,7 @@ static uint8_t const sbox[256] PROGMEM = {
 };
 
 // AES inverse S-box (http://en.wikipedia.org/wiki/Rijndael_S-box)
-static uint8_t const sbox_inverse[256] PROGMEM = {
+static uint8_t const sbox_inverse[256] = {
     0x52, 0x09, 0x6A, 0xD5, 0x30, 0x36, 0xA5, 0x38,     // 0x00
     0xBF, 0x40, 0xA3, 0x9E, 0x81, 0xF3, 0xD7, 0xFB,
     0x7C, 0xE3, 0x39, 0x82, 0x9B, 0x2F, 0xFF, 0x87,     // 0x10
@@ -146,37 +146,19 @@ size_t AESCommon::blockSize() const
     return 16;
 }
 
-// Constants to correct Galois multiplication for the high bits
-// that are shifted out when multiplying by powers of two.
-static uint8_t const K[8] = {
-    0x00,
-    0x1B,
-    (0x1B << 1),
-    (0x1B << 1) ^ 0x1B,
-    (0x1B << 2),
-    (0x1B << 2) ^ 0x1B,
-    (0x1B << 2) ^ (0x1B << 1),
-    (0x1B << 2) ^ (0x1B << 1) ^ 0x1B
-};
-
-// Multiply x by 2 in the Galois field, to achieve the effect of the following:
+// Multiply the four bytes of a column by 2 in the Galois field at once, to achieve the effect of the following
+// for every byte x:
 //
 //     if (x & 0x80)
 //         return (x << 1) ^ 0x1B;
 //     else
 //         return (x << 1);
 //
-// However, we don't want to use runtime conditionals if we can help it
-// to avoid leaking timing information from the implementation.
-// In this case, multiplication is slightly faster than table lookup on AVR.
-#define gmul2(x)    (t = ((uint16_t)(x)) << 1, \
-                     ((uint8_t)t) ^ (uint8_t)(0x1B * ((uint8_t)(t >> 8))))
-
-// Multiply x by 4 in the Galois field.
-#define gmul4(x)    (t = ((uint16_t)(x)) << 2, ((uint8_t)t) ^ K[t >> 8])
-
-// Multiply x by 8 in the Galois field.
-#define gmul8(x)    (t = ((uint16_t)(x)) << 3, ((uint8_t)t) ^ K[t >> 8])
+// without runtime conditionals (which would leak timing information) and without 8-bit arithmetic.
+static inline uint32_t gmul2x4(uint32_t x)
+{
+    return ((x & 0x7F7F7F7F) << 1) ^ (((x >> 7) & 0x01010101) * 0x1B);
+}
 
 #define OUT(col, row)   output[(col) * 4 + (row)]
 #define IN(col, row)    input[(col) * 4 + (row)]
@@ -185,84 +167,61 @@ static uint8_t const K[8] = {
 
 void AESCommon::subBytesAndShiftRows(uint8_t *output, const uint8_t *input)
 {
-    OUT(0, 0) = pgm_read_byte(sbox + IN(0, 0));
-    OUT(0, 1) = pgm_read_byte(sbox + IN(1, 1));
-    OUT(0, 2) = pgm_read_byte(sbox + IN(2, 2));
-    OUT(0, 3) = pgm_read_byte(sbox + IN(3, 3));
-    OUT(1, 0) = pgm_read_byte(sbox + IN(1, 0));
-    OUT(1, 1) = pgm_read_byte(sbox + IN(2, 1));
-    OUT(1, 2) = pgm_read_byte(sbox + IN(3, 2));
-    OUT(1, 3) = pgm_read_byte(sbox + IN(0, 3));
-    OUT(2, 0) = pgm_read_byte(sbox + IN(2, 0));
-    OUT(2, 1) = pgm_read_byte(sbox + IN(3, 1));
-    OUT(2, 2) = pgm_read_byte(sbox + IN(0, 2));
-    OUT(2, 3) = pgm_read_byte(sbox + IN(1, 3));
-    OUT(3, 0) = pgm_read_byte(sbox + IN(3, 0));
-    OUT(3, 1) = pgm_read_byte(sbox + IN(0, 1));
-    OUT(3, 2) = pgm_read_byte(sbox + IN(1, 2));
-    OUT(3, 3) = pgm_read_byte(sbox + IN(2, 3));
+    OUT(0, 0) = sbox[IN(0, 0)];
+    OUT(0, 1) = sbox[IN(1, 1)];
+    OUT(0, 2) = sbox[IN(2, 2)];
+    OUT(0, 3) = sbox[IN(3, 3)];
+    OUT(1, 0) = sbox[IN(1, 0)];
+    OUT(1, 1) = sbox[IN(2, 1)];
+    OUT(1, 2) = sbox[IN(3, 2)];
+    OUT(1, 3) = sbox[IN(0, 3)];
+    OUT(2, 0) = sbox[IN(2, 0)];
+    OUT(2, 1) = sbox[IN(3, 1)];
+    OUT(2, 2) = sbox[IN(0, 2)];
+    OUT(2, 3) = sbox[IN(1, 3)];
+    OUT(3, 0) = sbox[IN(3, 0)];
+    OUT(3, 1) = sbox[IN(0, 1)];
+    OUT(3, 2) = sbox[IN(1, 2)];
+    OUT(3, 3) = sbox[IN(2, 3)];
 }
 
 void AESCommon::inverseShiftRowsAndSubBytes(uint8_t *output, const uint8_t *input)
 {
-    OUT(0, 0) = pgm_read_byte(sbox_inverse + IN(0, 0));
-    OUT(0, 1) = pgm_read_byte(sbox_inverse + IN(3, 1));
-    OUT(0, 2) = pgm_read_byte(sbox_inverse + IN(2, 2));
-    OUT(0, 3) = pgm_read_byte(sbox_inverse + IN(1, 3));
-    OUT(1, 0) = pgm_read_byte(sbox_inverse + IN(1, 0));
-    OUT(1, 1) = pgm_read_byte(sbox_inverse + IN(0, 1));
-    OUT(1, 2) = pgm_read_byte(sbox_inverse + IN(3, 2));
-    OUT(1, 3) = pgm_read_byte(sbox_inverse + IN(2, 3));
-    OUT(2, 0) = pgm_read_byte(sbox_inverse + IN(2, 0));
-    OUT(2, 1) = pgm_read_byte(sbox_inverse + IN(1, 1));
-    OUT(2, 2) = pgm_read_byte(sbox_inverse + IN(0, 2));
-    OUT(2, 3) = pgm_read_byte(sbox_inverse + IN(3, 3));
-    OUT(3, 0) = pgm_read_byte(sbox_inverse + IN(3, 0));
-    OUT(3, 1) = pgm_read_byte(sbox_inverse + IN(2, 1));
-    OUT(3, 2) = pgm_read_byte(sbox_inverse + IN(1, 2));
-    OUT(3, 3) = pgm_read_byte(sbox_inverse + IN(0, 3));
+    OUT(0, 0) = sbox_inverse[IN(0, 0)];
+    OUT(0, 1) = sbox_inverse[IN(3, 1)];
+    OUT(0, 2) = sbox_inverse[IN(2, 2)];
+    OUT(0, 3) = sbox_inverse[IN(1, 3)];
+    OUT(1, 0) = sbox_inverse[IN(1, 0)];
+    OUT(1, 1) = sbox_inverse[IN(0, 1)];
+    OUT(1, 2) = sbox_inverse[IN(3, 2)];
+    OUT(1, 3) = sbox_inverse[IN(2, 3)];
+    OUT(2, 0) = sbox_inverse[IN(2, 0)];
+    OUT(2, 1) = sbox_inverse[IN(1, 1)];
+    OUT(2, 2) = sbox_inverse[IN(0, 2)];
+    OUT(2, 3) = sbox_inverse[IN(3, 3)];
+    OUT(3, 0) = sbox_inverse[IN(3, 0)];
+    OUT(3, 1) = sbox_inverse[IN(2, 1)];
+    OUT(3, 2) = sbox_inverse[IN(1, 2)];
+    OUT(3, 3) = sbox_inverse[IN(0, 3)];
 }
 
 void AESCommon::mixColumn(uint8_t *output, uint8_t *input)
 {
-    uint16_t t; // Needed by the gmul2 macro.
-    uint8_t a = input[0];
-    uint8_t b = input[1];
-    uint8_t c = input[2];
-    uint8_t d = input[3];
-    uint8_t a2 = gmul2(a);
-    uint8_t b2 = gmul2(b);
-    uint8_t c2 = gmul2(c);
-    uint8_t d2 = gmul2(d);
-    output[0] = a2 ^ b2 ^ b ^ c ^ d;
-    output[1] = a ^ b2 ^ c2 ^ c ^ d;
-    output[2] = a ^ b ^ c2 ^ d2 ^ d;
-    output[3] = a2 ^ a ^ b ^ c ^ d2;
+    // The column as one word, a in the low byte: the output bytes are
+    // 2a ^ 3b ^ c ^ d, 2b ^ 3c ^ d ^ a, 2c ^ 3d ^ a ^ b and 2d ^ 3a ^ b ^ c.
+    uint32_t x = load_le32(input);
+    uint32_t x2 = gmul2x4(x);
+    store_le32(output, x2 ^ rotr32(x ^ x2, 8) ^ rotr32(x, 16) ^ rotr32(x, 24));
 }
 
 void AESCommon::inverseMixColumn(uint8_t *output, const uint8_t *input)
 {
-    uint16_t t; // Needed by the gmul2, gmul4, and gmul8 macros.
-    uint8_t a = input[0];
-    uint8_t b = input[1];
-    uint8_t c = input[2];
-    uint8_t d = input[3];
-    uint8_t a2 = gmul2(a);
-    uint8_t b2 = gmul2(b);
-    uint8_t c2 = gmul2(c);
-    uint8_t d2 = gmul2(d);
-    uint8_t a4 = gmul4(a);
-    uint8_t b4 = gmul4(b);
-    uint8_t c4 = gmul4(c);
-    uint8_t d4 = gmul4(d);
-    uint8_t a8 = gmul8(a);
-    uint8_t b8 = gmul8(b);
-    uint8_t c8 = gmul8(c);
-    uint8_t d8 = gmul8(d);
-    output[0] = a8 ^ a4 ^ a2 ^ b8 ^ b2 ^ b ^ c8 ^ c4 ^ c ^ d8 ^ d;
-    output[1] = a8 ^ a ^ b8 ^ b4 ^ b2 ^ c8 ^ c2 ^ c ^ d8 ^ d4 ^ d;
-    output[2] = a8 ^ a4 ^ a ^ b8 ^ b ^ c8 ^ c4 ^ c2 ^ d8 ^ d2 ^ d;
-    output[3] = a8 ^ a2 ^ a ^ b8 ^ b4 ^ b ^ c8 ^ c ^ d8 ^ d4 ^ d2;
+    // InvMixColumns = MixColumns after adding 4 * (a ^ c) to a and c and 4 * (b ^ d) to b and d.
+    uint32_t x = load_le32(input);
+    uint32_t x4 = gmul2x4(gmul2x4(x));
+    x ^= x4 ^ rotr32(x4, 16);
+    uint32_t x2 = gmul2x4(x);
+    store_le32(output, x2 ^ rotr32(x ^ x2, 8) ^ rotr32(x, 16) ^ rotr32(x, 24));
 }
 
 /** @endcond */
@@ -340,22 +299,22 @@ void AESCommon::keyScheduleCore(uint8_t *output, const uint8_t *input, uint8_t i
 {
     // Rcon(i), 2^i in the Rijndael finite field, for i = 0..10.
     // http://en.wikipedia.org/wiki/Rijndael_key_schedule
-    static uint8_t const rcon[11] PROGMEM = {
+    static uint8_t const rcon[11] = {
         0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40,     // 0x00
         0x80, 0x1B, 0x36
     };
-    output[0] = pgm_read_byte(sbox + input[1]) ^ pgm_read_byte(rcon + iteration);
-    output[1] = pgm_read_byte(sbox + input[2]);
-    output[2] = pgm_read_byte(sbox + input[3]);
-    output[3] = pgm_read_byte(sbox + input[0]);
+    output[0] = sbox[input[1]] ^ rcon[iteration];
+    output[1] = sbox[input[2]];
+    output[2] = sbox[input[3]];
+    output[3] = sbox[input[0]];
 }
 
 void AESCommon::applySbox(uint8_t *output, const uint8_t *input)
 {
-    output[0] = pgm_read_byte(sbox + input[0]);
-    output[1] = pgm_read_byte(sbox + input[1]);
-    output[2] = pgm_read_byte(sbox + input[2]);
-    output[3] = pgm_read_byte(sbox + input[3]);
+    output[0] = sbox[input[0]];
+    output[1] = sbox[input[1]];
+    output[2] = sbox[input[2]];
+    output[3] = sbox[input[3]];
 }
 
 /** @endcond */
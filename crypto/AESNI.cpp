@@ -0,0 +1,294 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include "crypto/AESNI.h"
+#include "crypto/Crypto.h"
+
+#if defined(CRYPTO_AESNI)
+
+#include <wmmintrin.h>
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AESNI_TARGET
+#else
+#include <cpuid.h>
+#define AESNI_TARGET __attribute__((target("aes,sse2")))
+#endif
+
+
+static bool aesni_cpuid()
+{
+// CPUID leaf 1, ECX bit 25: AES instructions
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    return (regs[2] & (1 << 25)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+    return (ecx & (1 << 25)) != 0;
+#endif
+}
+
+
+// One step of the AES-256 key expansion: a is round key i-2, assist the broadcast aeskeygenassist word of round key i-1
+AESNI_TARGET static inline __m128i aesni_expand_step(__m128i a, __m128i assist)
+{
+    a = _mm_xor_si128(a, _mm_slli_si128(a, 4));
+    a = _mm_xor_si128(a, _mm_slli_si128(a, 4));
+    a = _mm_xor_si128(a, _mm_slli_si128(a, 4));
+    return _mm_xor_si128(a, assist);
+}
+
+#define AESNI_EXPAND_EVEN(i, rcon) \
+    do { \
+        k[i] = aesni_expand_step(k[i-2], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k[i-1], rcon), 0xff)); \
+    } while (0)
+#define AESNI_EXPAND_ODD(i) \
+    do { \
+        k[i] = aesni_expand_step(k[i-2], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k[i-1], 0x00), 0xaa)); \
+    } while (0)
+
+
+AESNI_TARGET void aesni_expand_key256(uint8_t *schedule, const uint8_t *key)
+{
+    __m128i k[15];
+    int i;
+
+    k[0] = _mm_loadu_si128((const __m128i*) key);
+    k[1] = _mm_loadu_si128((const __m128i*) (key + 16));
+    AESNI_EXPAND_EVEN(2, 0x01);   AESNI_EXPAND_ODD(3);
+    AESNI_EXPAND_EVEN(4, 0x02);   AESNI_EXPAND_ODD(5);
+    AESNI_EXPAND_EVEN(6, 0x04);   AESNI_EXPAND_ODD(7);
+    AESNI_EXPAND_EVEN(8, 0x08);   AESNI_EXPAND_ODD(9);
+    AESNI_EXPAND_EVEN(10, 0x10);  AESNI_EXPAND_ODD(11);
+    AESNI_EXPAND_EVEN(12, 0x20);  AESNI_EXPAND_ODD(13);
+    AESNI_EXPAND_EVEN(14, 0x40);
+
+    for (i = 0; i < 15; i++) {
+        _mm_storeu_si128((__m128i*) (schedule + i * 16), k[i]);
+        k[i] = _mm_setzero_si128();
+    }
+}
+
+
+AESNI_TARGET void aesni_inverse_schedule(uint8_t *output, const uint8_t *schedule, int rounds)
+{
+// Equivalent inverse cipher: round keys in reverse order, InvMixColumns applied to all but the first and last
+    int i;
+
+    memcpy(output, schedule + rounds * 16, 16);
+    for (i = 1; i < rounds; i++) {
+        _mm_storeu_si128((__m128i*) (output + i * 16), _mm_aesimc_si128(_mm_loadu_si128((const __m128i*) (schedule + (rounds - i) * 16))));
+    }
+    memcpy(output + rounds * 16, schedule, 16);
+}
+
+
+AESNI_TARGET void aesni_encrypt_block(const uint8_t *schedule, int rounds, uint8_t *output, const uint8_t *input)
+{
+    __m128i state;
+    int i;
+
+    state = _mm_xor_si128(_mm_loadu_si128((const __m128i*) input), _mm_loadu_si128((const __m128i*) schedule));
+    for (i = 1; i < rounds; i++) {
+        state = _mm_aesenc_si128(state, _mm_loadu_si128((const __m128i*) (schedule + i * 16)));
+    }
+    state = _mm_aesenclast_si128(state, _mm_loadu_si128((const __m128i*) (schedule + rounds * 16)));
+    _mm_storeu_si128((__m128i*) output, state);
+}
+
+
+AESNI_TARGET void aesni_decrypt_block(const uint8_t *inverseSchedule, int rounds, uint8_t *output, const uint8_t *input)
+{
+    __m128i state;
+    int i;
+
+    state = _mm_xor_si128(_mm_loadu_si128((const __m128i*) input), _mm_loadu_si128((const __m128i*) inverseSchedule));
+    for (i = 1; i < rounds; i++) {
+        state = _mm_aesdec_si128(state, _mm_loadu_si128((const __m128i*) (inverseSchedule + i * 16)));
+    }
+    state = _mm_aesdeclast_si128(state, _mm_loadu_si128((const __m128i*) (inverseSchedule + rounds * 16)));
+    _mm_storeu_si128((__m128i*) output, state);
+}
+
+
+AESNI_TARGET void aesni_encrypt_blocks(const uint8_t *schedule, int rounds, uint8_t *output, const uint8_t *input, size_t count)
+{
+// Encrypt 8 independent blocks per pass (e.g. CTR counter blocks), see aesni_decrypt_blocks()
+    __m128i s0, s1, s2, s3, s4, s5, s6, s7, k;
+    int i;
+
+    while (count >= 8) {
+        k  = _mm_loadu_si128((const __m128i*) schedule);
+        s0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +   0)), k);
+        s1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +  16)), k);
+        s2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +  32)), k);
+        s3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +  48)), k);
+        s4 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +  64)), k);
+        s5 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +  80)), k);
+        s6 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +  96)), k);
+        s7 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input + 112)), k);
+        for (i = 1; i < rounds; i++) {
+            k  = _mm_loadu_si128((const __m128i*) (schedule + i * 16));
+            s0 = _mm_aesenc_si128(s0, k);
+            s1 = _mm_aesenc_si128(s1, k);
+            s2 = _mm_aesenc_si128(s2, k);
+            s3 = _mm_aesenc_si128(s3, k);
+            s4 = _mm_aesenc_si128(s4, k);
+            s5 = _mm_aesenc_si128(s5, k);
+            s6 = _mm_aesenc_si128(s6, k);
+            s7 = _mm_aesenc_si128(s7, k);
+        }
+        k = _mm_loadu_si128((const __m128i*) (schedule + rounds * 16));
+        _mm_storeu_si128((__m128i*) (output +   0), _mm_aesenclast_si128(s0, k));
+        _mm_storeu_si128((__m128i*) (output +  16), _mm_aesenclast_si128(s1, k));
+        _mm_storeu_si128((__m128i*) (output +  32), _mm_aesenclast_si128(s2, k));
+        _mm_storeu_si128((__m128i*) (output +  48), _mm_aesenclast_si128(s3, k));
+        _mm_storeu_si128((__m128i*) (output +  64), _mm_aesenclast_si128(s4, k));
+        _mm_storeu_si128((__m128i*) (output +  80), _mm_aesenclast_si128(s5, k));
+        _mm_storeu_si128((__m128i*) (output +  96), _mm_aesenclast_si128(s6, k));
+        _mm_storeu_si128((__m128i*) (output + 112), _mm_aesenclast_si128(s7, k));
+        input  += 128;
+        output += 128;
+        count  -= 8;
+    }
+
+    while (count > 0) {
+        aesni_encrypt_block(schedule, rounds, output, input);
+        input  += 16;
+        output += 16;
+        count  -= 1;
+    }
+}
+
+
+AESNI_TARGET void aesni_decrypt_blocks(const uint8_t *inverseSchedule, int rounds, uint8_t *output, const uint8_t *input, size_t count)
+{
+// Decrypt 8 independent blocks per pass - each aesdec has a latency of several cycles but a throughput of one per cycle
+    __m128i s0, s1, s2, s3, s4, s5, s6, s7, k;
+    int i;
+
+    while (count >= 8) {
+        k  = _mm_loadu_si128((const __m128i*) inverseSchedule);
+        s0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +   0)), k);
+        s1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +  16)), k);
+        s2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +  32)), k);
+        s3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +  48)), k);
+        s4 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +  64)), k);
+        s5 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +  80)), k);
+        s6 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input +  96)), k);
+        s7 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (input + 112)), k);
+        for (i = 1; i < rounds; i++) {
+            k  = _mm_loadu_si128((const __m128i*) (inverseSchedule + i * 16));
+            s0 = _mm_aesdec_si128(s0, k);
+            s1 = _mm_aesdec_si128(s1, k);
+            s2 = _mm_aesdec_si128(s2, k);
+            s3 = _mm_aesdec_si128(s3, k);
+            s4 = _mm_aesdec_si128(s4, k);
+            s5 = _mm_aesdec_si128(s5, k);
+            s6 = _mm_aesdec_si128(s6, k);
+            s7 = _mm_aesdec_si128(s7, k);
+        }
+        k = _mm_loadu_si128((const __m128i*) (inverseSchedule + rounds * 16));
+        _mm_storeu_si128((__m128i*) (output +   0), _mm_aesdeclast_si128(s0, k));
+        _mm_storeu_si128((__m128i*) (output +  16), _mm_aesdeclast_si128(s1, k));
+        _mm_storeu_si128((__m128i*) (output +  32), _mm_aesdeclast_si128(s2, k));
+        _mm_storeu_si128((__m128i*) (output +  48), _mm_aesdeclast_si128(s3, k));
+        _mm_storeu_si128((__m128i*) (output +  64), _mm_aesdeclast_si128(s4, k));
+        _mm_storeu_si128((__m128i*) (output +  80), _mm_aesdeclast_si128(s5, k));
+        _mm_storeu_si128((__m128i*) (output +  96), _mm_aesdeclast_si128(s6, k));
+        _mm_storeu_si128((__m128i*) (output + 112), _mm_aesdeclast_si128(s7, k));
+        input  += 128;
+        output += 128;
+        count  -= 8;
+    }
+
+    while (count > 0) {
+        aesni_decrypt_block(inverseSchedule, rounds, output, input);
+        input  += 16;
+        output += 16;
+        count  -= 1;
+    }
+}
+
+
+static bool aesni_selftest()
+{
+// FIPS-197, Appendix C.3 (AES-256)
+    static const uint8_t key[32] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+    };
+    static const uint8_t plaintext[16] = {
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+    };
+    static const uint8_t ciphertext[16] = {
+        0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89
+    };
+    uint8_t schedule[240];
+    uint8_t inverse[240];
+    uint8_t buffer[16];
+    uint8_t blocks[9 * 16];
+    int i;
+    bool ok;
+
+    aesni_expand_key256(schedule, key);
+    aesni_encrypt_block(schedule, 14, buffer, plaintext);
+    ok = (memcmp(buffer, ciphertext, 16) == 0);
+    aesni_inverse_schedule(inverse, schedule, 14);
+    aesni_decrypt_block(inverse, 14, buffer, ciphertext);
+    ok = ok && (memcmp(buffer, plaintext, 16) == 0);
+
+    // Multi-block path (one full pass of 8 plus one single block), in place:
+    for (i = 0; i < 9; i++)
+        memcpy(blocks + i * 16, ciphertext, 16);
+    aesni_decrypt_blocks(inverse, 14, blocks, blocks, 9);
+    for (i = 0; i < 9; i++)
+        ok = ok && (memcmp(blocks + i * 16, plaintext, 16) == 0);
+    aesni_encrypt_blocks(schedule, 14, blocks, blocks, 9);
+    for (i = 0; i < 9; i++)
+        ok = ok && (memcmp(blocks + i * 16, ciphertext, 16) == 0);
+
+    clean(schedule);
+    clean(inverse);
+    return ok;
+}
+
+
+bool aesni_available()
+{
+    static const bool available = aesni_cpuid() && aesni_selftest();   // Checked once (thread-safe initialization)
+
+    return available;
+}
+
+#else // CRYPTO_AESNI
+
+bool aesni_available()
+{
+    return false;
+}
+
+void aesni_expand_key256(uint8_t *, const uint8_t *) {}
+void aesni_inverse_schedule(uint8_t *, const uint8_t *, int) {}
+void aesni_encrypt_block(const uint8_t *, int, uint8_t *, const uint8_t *) {}
+void aesni_decrypt_block(const uint8_t *, int, uint8_t *, const uint8_t *) {}
+void aesni_encrypt_blocks(const uint8_t *, int, uint8_t *, const uint8_t *, size_t) {}
+void aesni_decrypt_blocks(const uint8_t *, int, uint8_t *, const uint8_t *, size_t) {}
+
+#endif // CRYPTO_AESNI
@@ -0,0 +1,41 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef AESNI_H
+#define AESNI_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// AES using the x86 AES-NI instructions.
+// The round keys use the byte layout of the portable AESCommon key schedule (FIPS-197 byte order).
+// Decryption needs the schedule of the "equivalent inverse cipher" (FIPS-197, 5.3.5), see aesni_inverse_schedule().
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CRYPTO_AESNI 1
+#endif
+
+// Returns true if the CPU supports AES-NI and the implementation passed the FIPS-197 known-answer test.
+// The check runs once, later calls return the cached result.
+bool aesni_available();
+
+void aesni_expand_key256(uint8_t *schedule, const uint8_t *key);
+void aesni_inverse_schedule(uint8_t *output, const uint8_t *schedule, int rounds);
+void aesni_encrypt_block(const uint8_t *schedule, int rounds, uint8_t *output, const uint8_t *input);
+void aesni_decrypt_block(const uint8_t *inverseSchedule, int rounds, uint8_t *output, const uint8_t *input);
+void aesni_encrypt_blocks(const uint8_t *schedule, int rounds, uint8_t *output, const uint8_t *input, size_t count);
+void aesni_decrypt_blocks(const uint8_t *inverseSchedule, int rounds, uint8_t *output, const uint8_t *input, size_t count);
+
+
+#endif // AESNI_H
@@ -112,6 +112,62 @@ BlockCipher::~BlockCipher()
  * \sa encryptBlock(), blockSize()
  */
 
+/**
+ * \brief Encrypts several independent blocks using this cipher.
+ *
+ * \param output The output buffer to put the ciphertext into.
+ * Must be at least \a count * blockSize() bytes in length.
+ * \param input The input buffer to read the plaintext from.  The
+ * buffers may be identical, but must not overlap otherwise.
+ * \param count The number of blocks to encrypt.
+ *
+ * The counterpart of decryptBlocks() for modes like CTR, where the
+ * encryptions of consecutive blocks do not depend on each other.  The
+ * same rules apply: the default implementation calls encryptBlock() for
+ * each block, and implementations must not modify the cipher object.
+ *
+ * \sa encryptBlock(), decryptBlocks()
+ */
+void BlockCipher::encryptBlocks(uint8_t *output, const uint8_t *input, size_t count)
+{
+    size_t size = blockSize();
+    while (count > 0) {
+        encryptBlock(output, input);
+        output += size;
+        input += size;
+        --count;
+    }
+}
+
+/**
+ * \brief Decrypts several independent blocks using this cipher.
+ *
+ * \param output The output buffer to put the plaintext into.
+ * Must be at least \a count * blockSize() bytes in length.
+ * \param input The input buffer to read the ciphertext from.  The
+ * buffers may be identical, but must not overlap otherwise.
+ * \param count The number of blocks to decrypt.
+ *
+ * The default implementation calls decryptBlock() for each block.
+ * Ciphers that can work on several blocks at once (e.g. AES-NI,
+ * which pipelines the rounds of independent blocks) override this.
+ *
+ * Implementations must not modify the state of the cipher object, so that
+ * disjoint parts of a buffer can be decrypted from several threads at once.
+ *
+ * \sa decryptBlock()
+ */
+void BlockCipher::decryptBlocks(uint8_t *output, const uint8_t *input, size_t count)
+{
+    size_t size = blockSize();
+    while (count > 0) {
+        decryptBlock(output, input);
+        output += size;
+        input += size;
+        --count;
+    }
+}
+
 /**
  * \fn void BlockCipher::clear()
  * \brief Clears all security-sensitive state from this block cipher.
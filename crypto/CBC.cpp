@@ -23,6 +23,46 @@
 #include "CBC.h"
 #include "Crypto.h"
 #include <string.h>
+#include <thread>
+#include <vector>
+
+// Blocks decrypted per call of BlockCipher::decryptBlocks() (the ciphertext
+// of one batch is copied to the stack, so decryption may work in place).
+#define CBC_BATCH_BLOCKS 64
+
+// Buffers of at least CBC_PARALLEL_MIN bytes are split across threads,
+// each thread getting at least CBC_PARALLEL_SLICE bytes.
+#define CBC_PARALLEL_MIN    (1024 * 1024)
+#define CBC_PARALLEL_SLICE  (256 * 1024)
+#define CBC_MAX_THREADS     8
+
+/** @cond cbc_decrypt */
+
+// Decrypts "blocks" blocks in CBC mode.  "iv" holds the previous ciphertext
+// block on entry and the last ciphertext block of this range on exit.
+static void cbcDecryptRange(BlockCipher *cipher, uint8_t *output, const uint8_t *input,
+                            size_t blocks, uint8_t *iv)
+{
+    uint8_t saved[CBC_BATCH_BLOCKS * 16];
+    size_t count, posn;
+
+    while (blocks > 0) {
+        count = blocks < CBC_BATCH_BLOCKS ? blocks : CBC_BATCH_BLOCKS;
+        memcpy(saved, input, count * 16);
+        cipher->decryptBlocks(output, saved, count);
+        for (posn = 0; posn < 16; ++posn)
+            output[posn] ^= iv[posn];
+        for (posn = 16; posn < count * 16; ++posn)
+            output[posn] ^= saved[posn - 16];
+        memcpy(iv, saved + (count - 1) * 16, 16);
+        input += count * 16;
+        output += count * 16;
+        blocks -= count;
+    }
+    clean(saved);
+}
+
+/** @endcond */
 
 /**
  * \class CBCCommon CBC.h <CBC.h>
@@ -96,18 +136,52 @@ void CBCCommon::encrypt(uint8_t *output, const uint8_t *input, size_t len)
     }
 }
 
+/**
+ * \brief Decrypts an input buffer and writes the plaintext to an output buffer.
+ *
+ * Unlike encryption, the block decryptions in CBC mode do not depend on
+ * each other, so the blocks are handed to BlockCipher::decryptBlocks() in
+ * batches.  Large buffers are split into slices that are decrypted in
+ * parallel; each slice starts from the ciphertext block in front of it.
+ *
+ * The \a output and \a input buffers may be identical.
+ */
 void CBCCommon::decrypt(uint8_t *output, const uint8_t *input, size_t len)
 {
-    uint8_t posn;
-    while (len >= 16) {
-        blockCipher->decryptBlock(temp, input);
-        for (posn = 0; posn < 16; ++posn) {
-            uint8_t in = *input++;
-            *output++ = temp[posn] ^ iv[posn];
-            iv[posn] = in;
-        }
-        len -= 16;
+    size_t blocks = len / 16;
+    size_t threads, slice, start, k;
+
+    threads = std::thread::hardware_concurrency();
+    if (threads > CBC_MAX_THREADS)
+        threads = CBC_MAX_THREADS;
+    if (threads > blocks * 16 / CBC_PARALLEL_SLICE)
+        threads = blocks * 16 / CBC_PARALLEL_SLICE;
+    if (blocks * 16 < CBC_PARALLEL_MIN || threads < 2) {
+        cbcDecryptRange(blockCipher, output, input, blocks, iv);
+        return;
     }
+
+    // Collect the IV of each slice before any thread starts, as decryption
+    // may overwrite the ciphertext in place.
+    slice = (blocks + threads - 1) / threads;
+    std::vector<uint8_t> ivs(threads * 16);
+    memcpy(&ivs[0], iv, 16);
+    for (k = 1; k < threads; ++k)
+        memcpy(&ivs[k * 16], input + (k * slice - 1) * 16, 16);
+    memcpy(iv, input + (blocks - 1) * 16, 16);
+
+    std::vector<std::thread> workers;
+    for (k = 1; k < threads; ++k) {
+        start = k * slice;
+        size_t count = (start + slice <= blocks) ? slice : blocks - start;
+        workers.push_back(std::thread(cbcDecryptRange, blockCipher, output + start * 16,
+                                      input + start * 16, count, &ivs[k * 16]));
+    }
+    cbcDecryptRange(blockCipher, output, input, slice, &ivs[0]);
+    for (k = 0; k < workers.size(); ++k)
+        workers[k].join();
+
+    clean(&ivs[0], ivs.size());
 }
 
 void CBCCommon::clear()
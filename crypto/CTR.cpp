@@ -0,0 +1,217 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "CTR.h"
+#include "Crypto.h"
+#include <string.h>
+
+// Keystream blocks generated per call of BlockCipher::encryptBlocks().
+#define CTR_BATCH_BLOCKS 64
+
+/**
+ * \class CTRCommon CTR.h <CTR.h>
+ * \brief Concrete base class to assist with implementing CTR mode for
+ * 128-bit block ciphers.
+ *
+ * Reference: http://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * \sa CTR
+ */
+
+/**
+ * \brief Constructs a new cipher in CTR mode.
+ *
+ * This constructor should be followed by a call to setBlockCipher().
+ * The counter is the last 4 bytes of the IV by default.
+ */
+CTRCommon::CTRCommon()
+    : blockCipher(0)
+    , posn(16)
+    , counterStart(12)
+{
+}
+
+/**
+ * \brief Destroys this cipher object after clearing sensitive information.
+ */
+CTRCommon::~CTRCommon()
+{
+    clean(counter);
+    clean(state);
+}
+
+size_t CTRCommon::keySize() const
+{
+    return blockCipher->keySize();
+}
+
+size_t CTRCommon::ivSize() const
+{
+    return 16;
+}
+
+/**
+ * \brief Sets the counter size for the IV.
+ *
+ * \param size The number of bytes on the end of the counter block
+ * that are incremented (big endian) for each block, between 1 and 16.
+ * \return Returns false if the \a size value is not between 1 and 16.
+ *
+ * The remaining bytes of the IV are a fixed nonce.  The counter wraps
+ * around within its bytes, so the caller must make sure that no more
+ * than 2^(8 * \a size) blocks are encrypted with one IV.
+ */
+bool CTRCommon::setCounterSize(size_t size)
+{
+    if (size < 1 || size > 16)
+        return false;
+    counterStart = 16 - size;
+    return true;
+}
+
+bool CTRCommon::setKey(const uint8_t *key, size_t len)
+{
+    // Verify the cipher's block size, just in case.
+    if (blockCipher->blockSize() != 16)
+        return false;
+
+    // Set the key on the underlying block cipher.
+    return blockCipher->setKey(key, len);
+}
+
+/**
+ * \brief Sets the initial counter block (nonce and counter).
+ */
+bool CTRCommon::setIV(const uint8_t *iv, size_t len)
+{
+    if (len != 16)
+        return false;
+    memcpy(counter, iv, 16);
+    posn = 16;
+    return true;
+}
+
+/**
+ * \brief Encrypts an input buffer and writes the ciphertext to an output buffer.
+ *
+ * The keystream is generated in batches with BlockCipher::encryptBlocks(),
+ * so ciphers that pipeline independent blocks (AES-NI) can do so.
+ * Partial blocks are allowed; the rest of the keystream block is used
+ * by the next call.  The \a output and \a input buffers may be identical.
+ */
+void CTRCommon::encrypt(uint8_t *output, const uint8_t *input, size_t len)
+{
+    uint8_t stream[CTR_BATCH_BLOCKS * 16];
+    size_t count, block, k;
+
+    // Use up the keystream left over from the previous call.
+    while (posn < 16 && len > 0) {
+        *output++ = *input++ ^ state[posn++];
+        --len;
+    }
+
+    // Whole blocks.
+    while (len >= 16) {
+        count = len / 16;
+        if (count > CTR_BATCH_BLOCKS)
+            count = CTR_BATCH_BLOCKS;
+        for (block = 0; block < count; ++block) {
+            memcpy(stream + block * 16, counter, 16);
+            increment();
+        }
+        blockCipher->encryptBlocks(stream, stream, count);
+        for (k = 0; k < count * 16; ++k)
+            output[k] = input[k] ^ stream[k];
+        input += count * 16;
+        output += count * 16;
+        len -= count * 16;
+    }
+
+    // Partial last block.
+    if (len > 0) {
+        blockCipher->encryptBlock(state, counter);
+        increment();
+        for (posn = 0; posn < len; ++posn)
+            output[posn] = input[posn] ^ state[posn];
+    }
+
+    clean(stream);
+}
+
+/**
+ * \brief Decrypts an input buffer and writes the plaintext to an output buffer.
+ *
+ * Same as encrypt() - CTR mode XORs the data with the keystream either way.
+ */
+void CTRCommon::decrypt(uint8_t *output, const uint8_t *input, size_t len)
+{
+    encrypt(output, input, len);
+}
+
+void CTRCommon::clear()
+{
+    blockCipher->clear();
+    clean(counter);
+    clean(state);
+    posn = 16;
+}
+
+// Increments the counter bytes of the counter block (big endian).
+void CTRCommon::increment()
+{
+    uint8_t index = 16;
+    while (index > counterStart) {
+        --index;
+        if (++counter[index] != 0)
+            break;
+    }
+}
+
+/**
+ * \fn void CTRCommon::setBlockCipher(BlockCipher *cipher)
+ * \brief Sets the block cipher to use for this CTR object.
+ *
+ * \param cipher The block cipher to use to implement CTR mode,
+ * which must have a block size of 16 bytes (128 bits).
+ */
+
+/**
+ * \class CTR CTR.h <CTR.h>
+ * \brief Implementation of the Counter (CTR) mode for 128-bit block ciphers.
+ *
+ * The template parameter T must be a concrete subclass of BlockCipher
+ * indicating the specific block cipher to use.  T must have a block size
+ * of 16 bytes (128 bits).
+ *
+ * \code
+ * CTR<AES256> ctr;
+ * ctr.setKey(key, 32);
+ * ctr.setIV(iv, 16);
+ * ctr.encrypt(output, input, len);
+ * \endcode
+ *
+ * Unlike CBC, the plaintext does not need to be padded, and the blocks
+ * can be processed in any order.  A counter block must never be used
+ * twice with the same key: every message needs a fresh nonce.
+ *
+ * Reference: http://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * \sa CBC
+ */
+
+/**
+ * \fn CTR::CTR()
+ * \brief Constructs a new CTR object for the block cipher T.
+ */
@@ -0,0 +1,354 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "crypto/ChunkCipher.h"
+#include "crypto/Crypto.h"
+#include "crypto/CTR.h"
+#include "crypto/AES.h"
+#include "crypto/SHA256.h"
+
+// Ranges of at least CHUNK_PARALLEL_MIN chunks are split across threads
+#define CHUNK_PARALLEL_MIN  16
+#define CHUNK_MAX_THREADS   8
+
+
+// Calls fn(index) for the chunks first ... first+count-1, on several threads for larger ranges
+template <typename F>
+static void forEachChunk(uint32_t first, uint32_t count, F fn)
+{
+    unsigned int threads, k;
+    uint32_t slice;
+    std::vector<std::thread> workers;
+
+    threads = std::thread::hardware_concurrency();
+    if (threads > CHUNK_MAX_THREADS) threads = CHUNK_MAX_THREADS;
+    if (threads > count / (CHUNK_PARALLEL_MIN / 2)) threads = count / (CHUNK_PARALLEL_MIN / 2);
+    if (count < CHUNK_PARALLEL_MIN || threads < 2) {
+        for (k = 0; k < count; k++) fn(first + k);
+        return;
+    }
+
+    slice = (count + threads - 1) / threads;
+    for (k = 1; k < threads && k * slice < count; k++) {
+        uint32_t start = first + k * slice;
+        uint32_t end   = first + ((k + 1) * slice < count ? (k + 1) * slice : count);
+        workers.push_back(std::thread([start, end, &fn]() {
+            for (uint32_t i = start; i < end; i++) fn(i);
+        }));
+    }
+    for (k = 0; k < slice; k++) fn(first + k);
+    for (k = 0; k < workers.size(); k++) workers[k].join();
+}
+
+
+ChunkCipher::ChunkCipher()
+{
+    memset(encKey, 0, sizeof(encKey));
+    memset(macKey, 0, sizeof(macKey));
+    memset(nonce, 0, sizeof(nonce));
+    headerLen = 0;
+}
+
+
+ChunkCipher::~ChunkCipher()
+{
+    clear();
+}
+
+
+void ChunkCipher::setKey(const uint8_t *key, size_t len)
+{
+// Separate keys for encryption and authentication, derived from the (PBKDF2) key
+    static const char encLabel[] = "Timekeeper chunk encryption";
+    static const char macLabel[] = "Timekeeper chunk authentication";
+    SHA256 hmac;
+
+    hmac.resetHMAC(key, len);
+    hmac.update(encLabel, sizeof(encLabel) - 1);
+    hmac.finalizeHMAC(key, len, encKey, 32);
+
+    hmac.resetHMAC(key, len);
+    hmac.update(macLabel, sizeof(macLabel) - 1);
+    hmac.finalizeHMAC(key, len, macKey, 32);
+}
+
+
+void ChunkCipher::setNonce(const uint8_t *nonce)
+{
+// Must be new for every seal() with the same key
+    memcpy(this->nonce, nonce, CHUNK_NONCE_SIZE);
+}
+
+
+bool ChunkCipher::setHeader(const uint8_t *header, size_t len)
+{
+// Data stored unencrypted in front of the chunks which is authenticated along with every chunk
+    if (len > CHUNK_HEADER_MAX) return false;
+    memcpy(this->header, header, len);
+    headerLen = len;
+    return true;
+}
+
+
+void ChunkCipher::clear()
+{
+    clean(encKey);
+    clean(macKey);
+    clean(nonce);
+    clean(header);
+    headerLen = 0;
+}
+
+
+uint32_t ChunkCipher::chunkCount(size_t plainSize)
+{
+// An empty buffer still has one (empty) chunk, so its tag marks the end of the data
+    if (plainSize == 0) return 1;
+    return (uint32_t) ((plainSize + CHUNK_SIZE - 1) / CHUNK_SIZE);
+}
+
+
+size_t ChunkCipher::sealedSize(size_t plainSize)
+{
+    return plainSize + (size_t) chunkCount(plainSize) * CHUNK_TAG_SIZE;
+}
+
+
+bool ChunkCipher::openedSize(size_t sealedSize, size_t *plainSize)
+{
+// Size of the plaintext for the given size of sealed data - false if no plaintext seals to this size
+    size_t chunks, rest;
+
+    if (sealedSize < CHUNK_TAG_SIZE) return false;
+    chunks = (sealedSize + CHUNK_SIZE + CHUNK_TAG_SIZE - 1) / (CHUNK_SIZE + CHUNK_TAG_SIZE);
+    rest   = sealedSize - (chunks - 1) * (CHUNK_SIZE + CHUNK_TAG_SIZE);
+    if (rest < CHUNK_TAG_SIZE) return false;
+    if (rest == CHUNK_TAG_SIZE && chunks > 1) return false;   // An empty chunk only exists for empty data
+    *plainSize = sealedSize - chunks * CHUNK_TAG_SIZE;
+    return true;
+}
+
+
+void ChunkCipher::seal(uint8_t *data, size_t plainSize) const
+{
+// Encrypt plainSize bytes at data in place and insert the tags
+// The buffer must hold sealedSize(plainSize) bytes
+    uint32_t chunks, i;
+
+    chunks = chunkCount(plainSize);
+
+    // Move the chunks to their final position, back to front:
+    for (i = chunks - 1; i > 0; i--) {
+        memmove(data + (size_t) i * (CHUNK_SIZE + CHUNK_TAG_SIZE), data + (size_t) i * CHUNK_SIZE,
+                i < chunks - 1 ? CHUNK_SIZE : plainSize - (size_t) i * CHUNK_SIZE);
+    }
+
+    forEachChunk(0, chunks, [this, data, plainSize, chunks](uint32_t index) {
+        size_t len = (index < chunks - 1) ? CHUNK_SIZE : plainSize - (size_t) index * CHUNK_SIZE;
+        sealChunk(index, index == chunks - 1, data + (size_t) index * (CHUNK_SIZE + CHUNK_TAG_SIZE), len);
+    });
+}
+
+
+bool ChunkCipher::open(uint8_t *data, size_t sealedSize, uint32_t first, uint32_t count) const
+{
+// Verify and decrypt the chunks first ... first+count-1 of the sealed data in place (tags stay where they are, see compact())
+// Returns false if a tag does not match - the chunk is left encrypted then
+    return openChunks(data + (size_t) first * (CHUNK_SIZE + CHUNK_TAG_SIZE), sealedSize, first, count);
+}
+
+
+bool ChunkCipher::openChunks(uint8_t *chunks, size_t sealedSize, uint32_t first, uint32_t count) const
+{
+// Like open(), but chunks points to chunk "first" - for reading a file piece by piece into a small buffer.
+// sealedSize is the size of the whole sealed data (it tells which chunk is the last one).
+    size_t   plainSize;
+    uint32_t total;
+    std::vector<uint8_t> failed;
+
+    if (!openedSize(sealedSize, &plainSize)) return false;
+    total = chunkCount(plainSize);
+    if (first >= total || count > total - first) return false;
+
+    failed.assign(count, 0);
+    forEachChunk(first, count, [this, chunks, plainSize, total, first, &failed](uint32_t index) {
+        size_t len = (index < total - 1) ? CHUNK_SIZE : plainSize - (size_t) index * CHUNK_SIZE;
+        if (!openChunk(index, index == total - 1, chunks + (size_t) (index - first) * (CHUNK_SIZE + CHUNK_TAG_SIZE), len))
+            failed[index - first] = 1;
+    });
+
+    for (uint32_t k = 0; k < count; k++) {
+        if (failed[k]) return false;
+    }
+    return true;
+}
+
+
+size_t ChunkCipher::compact(uint8_t *data, size_t sealedSize)
+{
+// Remove the tags from opened data, returns the size of the plaintext now at the start of data
+    size_t   plainSize;
+    uint32_t chunks, i;
+
+    if (!openedSize(sealedSize, &plainSize)) return 0;
+    chunks = chunkCount(plainSize);
+    for (i = 1; i < chunks; i++) {
+        memmove(data + (size_t) i * CHUNK_SIZE, data + (size_t) i * (CHUNK_SIZE + CHUNK_TAG_SIZE),
+                i < chunks - 1 ? CHUNK_SIZE : plainSize - (size_t) i * CHUNK_SIZE);
+    }
+    return plainSize;
+}
+
+
+void ChunkCipher::sealPage(uint32_t index, uint8_t *page) const
+{
+// Encrypt the plaintext of a page in place and append the tag - the nonce must already be set
+    crypt(page, 0, page + CHUNK_PAGE_NONCE, CHUNK_PAGE_SIZE);
+    pageTag(index, page, page + CHUNK_PAGE_NONCE + CHUNK_PAGE_SIZE);
+}
+
+
+bool ChunkCipher::openPage(uint32_t index, uint8_t *page) const
+{
+// Verify and decrypt a page in place - returns false if the tag does not match
+    uint8_t expected[CHUNK_TAG_SIZE];
+    bool    ok;
+
+    pageTag(index, page, expected);
+    ok = secure_compare(expected, page + CHUNK_PAGE_NONCE + CHUNK_PAGE_SIZE, CHUNK_TAG_SIZE);
+    if (ok) crypt(page, 0, page + CHUNK_PAGE_NONCE, CHUNK_PAGE_SIZE);
+    clean(expected);
+
+    return ok;
+}
+
+
+void ChunkCipher::sealPages(uint8_t *pages, uint32_t first, uint32_t count) const
+{
+// Seal consecutive pages (pages points to page "first"), on several threads for larger ranges
+    forEachChunk(first, count, [this, pages, first](uint32_t index) {
+        sealPage(index, pages + (size_t) (index - first) * CHUNK_PAGE_STORED);
+    });
+}
+
+
+bool ChunkCipher::openPages(uint8_t *pages, uint32_t first, uint32_t count) const
+{
+// Open consecutive pages (pages points to page "first") - returns false if any tag does not match
+    std::vector<uint8_t> failed(count, 0);
+
+    forEachChunk(first, count, [this, pages, first, &failed](uint32_t index) {
+        if (!openPage(index, pages + (size_t) (index - first) * CHUNK_PAGE_STORED))
+            failed[index - first] = 1;
+    });
+
+    for (uint32_t k = 0; k < count; k++) {
+        if (failed[k]) return false;
+    }
+    return true;
+}
+
+
+void ChunkCipher::rootTag(const uint8_t *info, size_t len, const uint8_t *tags, uint32_t count, uint8_t *out) const
+{
+// Tag over the header, some file information (e.g. page count) and the tags of all pages (count * CHUNK_TAG_SIZE bytes)
+    SHA256 hmac;
+
+    hmac.resetHMAC(macKey, 32);
+    hmac.update(header, headerLen);
+    hmac.update(info, len);
+    hmac.update(tags, (size_t) count * CHUNK_TAG_SIZE);
+    hmac.finalizeHMAC(macKey, 32, out, CHUNK_TAG_SIZE);
+}
+
+
+void ChunkCipher::sealChunk(uint32_t index, bool last, uint8_t *chunk, size_t len) const
+{
+    crypt(nonce, index * (CHUNK_SIZE / 16), chunk, len);
+    tag(index, last, chunk, len, chunk + len);
+}
+
+
+bool ChunkCipher::openChunk(uint32_t index, bool last, uint8_t *chunk, size_t len) const
+{
+    uint8_t expected[CHUNK_TAG_SIZE];
+    bool    ok;
+
+    tag(index, last, chunk, len, expected);
+    ok = secure_compare(expected, chunk + len, CHUNK_TAG_SIZE);
+    if (ok) crypt(nonce, index * (CHUNK_SIZE / 16), chunk, len);
+    clean(expected);
+
+    return ok;
+}
+
+
+void ChunkCipher::crypt(const uint8_t *nonce, uint32_t block, uint8_t *data, size_t len) const
+{
+// CTR keystream starting at the given block - for chunks the counter continues across the file, so no counter block is used twice
+    CTR<AES256> ctr;
+    uint8_t  iv[16];
+
+    memcpy(iv, nonce, CHUNK_NONCE_SIZE);
+    iv[12] = (uint8_t) (block >> 24);
+    iv[13] = (uint8_t) (block >> 16);
+    iv[14] = (uint8_t) (block >> 8);
+    iv[15] = (uint8_t) block;
+
+    ctr.setKey(encKey, 32);
+    ctr.setIV(iv, 16);
+    ctr.encrypt(data, data, len);
+    clean(iv);
+}
+
+
+void ChunkCipher::tag(uint32_t index, bool last, const uint8_t *chunk, size_t len, uint8_t *out) const
+{
+    SHA256  hmac;
+    uint8_t info[5];
+
+    info[0] = (uint8_t) (index >> 24);
+    info[1] = (uint8_t) (index >> 16);
+    info[2] = (uint8_t) (index >> 8);
+    info[3] = (uint8_t) index;
+    info[4] = last ? 1 : 0;
+
+    hmac.resetHMAC(macKey, 32);
+    hmac.update(header, headerLen);
+    hmac.update(nonce, CHUNK_NONCE_SIZE);
+    hmac.update(info, 5);
+    hmac.update(chunk, len);
+    hmac.finalizeHMAC(macKey, 32, out, CHUNK_TAG_SIZE);
+}
+
+
+void ChunkCipher::pageTag(uint32_t index, const uint8_t *page, uint8_t *out) const
+{
+    SHA256  hmac;
+    uint8_t info[4];
+
+    info[0] = (uint8_t) (index >> 24);
+    info[1] = (uint8_t) (index >> 16);
+    info[2] = (uint8_t) (index >> 8);
+    info[3] = (uint8_t) index;
+
+    hmac.resetHMAC(macKey, 32);
+    hmac.update(header, headerLen);
+    hmac.update(info, 4);
+    hmac.update(page, CHUNK_PAGE_NONCE + CHUNK_PAGE_SIZE);   // Nonce & ciphertext
+    hmac.finalizeHMAC(macKey, 32, out, CHUNK_TAG_SIZE);
+}
@@ -0,0 +1,93 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CHUNKCIPHER_H
+#define CHUNKCIPHER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Authenticated encryption of a buffer in fixed-size chunks (save file version 102).
+//
+// Each chunk is encrypted with AES-256 in CTR mode and followed by an HMAC-SHA256 tag:
+//
+//   chunk 0 (CHUNK_SIZE bytes) | tag 0 | chunk 1 | tag 1 | ... | last chunk (0..CHUNK_SIZE bytes) | last tag
+//
+// The counter block is the nonce (random for every save) followed by the 32 bit index of the block within the file.
+// The tag covers the header set with setHeader(), the nonce, the chunk index, a flag marking the last chunk and the
+// ciphertext of the chunk, so modified, reordered, truncated or extended data is detected chunk by chunk.
+// Encryption and MAC keys are derived from the key passed to setKey() with HMAC-SHA256.
+//
+// Chunks do not depend on each other: seal() and open() spread large buffers across several threads,
+// and a reader can verify and decrypt a file piece by piece.
+// seal() and open() do not modify the object, several threads may use it at the same time.
+//
+// Pages (save file version 103) are small chunks that can be rewritten in place, each stored with its own nonce:
+//
+//   nonce (CHUNK_PAGE_NONCE bytes) | ciphertext (CHUNK_PAGE_SIZE bytes) | tag
+//
+// A page is encrypted with the counter block nonce | 0, its tag covers the header, the page index, the nonce and the
+// ciphertext. The caller fills in a fresh random nonce every time a page is sealed. rootTag() authenticates the
+// tags of all pages together, so pages can neither be dropped nor replaced by an older version of themselves.
+
+#define CHUNK_SIZE          65536   // Plaintext bytes per chunk
+#define CHUNK_TAG_SIZE      32      // HMAC-SHA256
+#define CHUNK_NONCE_SIZE    12
+#define CHUNK_HEADER_MAX    64      // Max. length of the authenticated header
+
+#define CHUNK_PAGE_SIZE     1024    // Plaintext bytes per page
+#define CHUNK_PAGE_NONCE    CHUNK_NONCE_SIZE
+#define CHUNK_PAGE_STORED   (CHUNK_PAGE_NONCE + CHUNK_PAGE_SIZE + CHUNK_TAG_SIZE)
+
+class ChunkCipher
+{
+public:
+    ChunkCipher();
+    ~ChunkCipher();
+
+    void setKey(const uint8_t *key, size_t len);
+    void setNonce(const uint8_t *nonce);
+    bool setHeader(const uint8_t *header, size_t len);
+    void clear();
+
+    static uint32_t chunkCount(size_t plainSize);
+    static size_t   sealedSize(size_t plainSize);
+    static bool     openedSize(size_t sealedSize, size_t *plainSize);
+
+    void   seal(uint8_t *data, size_t plainSize) const;
+    bool   open(uint8_t *data, size_t sealedSize, uint32_t first, uint32_t count) const;
+    bool   openChunks(uint8_t *chunks, size_t sealedSize, uint32_t first, uint32_t count) const;
+    static size_t compact(uint8_t *data, size_t sealedSize);
+
+    void   sealPage(uint32_t index, uint8_t *page) const;
+    bool   openPage(uint32_t index, uint8_t *page) const;
+    void   sealPages(uint8_t *pages, uint32_t first, uint32_t count) const;
+    bool   openPages(uint8_t *pages, uint32_t first, uint32_t count) const;
+    void   rootTag(const uint8_t *info, size_t len, const uint8_t *tags, uint32_t count, uint8_t *out) const;
+
+private:
+    uint8_t encKey[32];
+    uint8_t macKey[32];
+    uint8_t nonce[CHUNK_NONCE_SIZE];
+    uint8_t header[CHUNK_HEADER_MAX];
+    size_t  headerLen;
+
+    void sealChunk(uint32_t index, bool last, uint8_t *chunk, size_t len) const;
+    bool openChunk(uint32_t index, bool last, uint8_t *chunk, size_t len) const;
+    void crypt(const uint8_t *nonce, uint32_t block, uint8_t *data, size_t len) const;
+    void tag(uint32_t index, bool last, const uint8_t *chunk, size_t len, uint8_t *out) const;
+    void pageTag(uint32_t index, const uint8_t *page, uint8_t *out) const;
+};
+
+#endif // CHUNKCIPHER_H
@@ -22,10 +22,19 @@
 
 #include "SHA1.h"
 #include "Crypto.h"
-#include "utility/RotateUtil.h"
-#include "utility/EndianUtil.h"
+#include "utility/Intrinsics.h"
+#include "SHAAccel.h"
 #include <string.h>
 
+// Accelerated compression function for this CPU, or 0 to use the portable processChunk()
+static sha_blocks_fn sha1_accel()
+{
+    static const sha_blocks_fn blocks = shani_available() ? shani_sha1_blocks :
+                                          (ssse3_sha_available() ? ssse3_sha1_blocks : 0);   // Selected once (thread-safe initialization)
+
+    return blocks;
+}
+
 /**
  * \class SHA1 SHA1.h <SHA1.h>
  * \brief SHA-1 hash algorithm.
@@ -79,7 +88,16 @@ void SHA1::update(const void *data, size_t len)
 
     // Break the input up into 512-bit chunks and process each in turn.
     const uint8_t *d = (const uint8_t *)data;
+    sha_blocks_fn blocks = sha1_accel();
     while (len > 0) {
+        // Whole blocks can be compressed straight from the caller's buffer.
+        if (blocks && state.chunkSize == 0 && len >= 64) {
+            size_t count = len / 64;
+            blocks(state.h, d, count);
+            len -= count * 64;
+            d += count * 64;
+            continue;
+        }
         uint8_t size = 64 - state.chunkSize;
         if (size > len)
             size = len;
@@ -102,22 +120,22 @@ void SHA1::finalize(void *hash, size_t len)
     if (state.chunkSize <= (64 - 9)) {
         wbytes[state.chunkSize] = 0x80;
         memset(wbytes + state.chunkSize + 1, 0x00, 64 - 8 - (state.chunkSize + 1));
-        state.w[14] = htobe32((uint32_t)(state.length >> 32));
-        state.w[15] = htobe32((uint32_t)state.length);
+        state.w[14] = bswap32((uint32_t)(state.length >> 32));
+        state.w[15] = bswap32((uint32_t)state.length);
         processChunk();
     } else {
         wbytes[state.chunkSize] = 0x80;
         memset(wbytes + state.chunkSize + 1, 0x00, 64 - (state.chunkSize + 1));
         processChunk();
         memset(wbytes, 0x00, 64 - 8);
-        state.w[14] = htobe32((uint32_t)(state.length >> 32));
-        state.w[15] = htobe32((uint32_t)state.length);
+        state.w[14] = bswap32((uint32_t)(state.length >> 32));
+        state.w[15] = bswap32((uint32_t)state.length);
         processChunk();
     }
 
     // Convert the result into big endian and return it.
     for (uint8_t posn = 0; posn < 5; ++posn)
-        state.w[posn] = htobe32(state.h[posn]);
+        state.w[posn] = bswap32(state.h[posn]);
 
     // Copy the hash to the caller's return buffer.
     if (len > 20)
@@ -157,11 +175,17 @@ void SHA1::finalizeHMAC(const void *key, size_t keyLen, void *hash, size_t hashL
  */
 void SHA1::processChunk()
 {
+    sha_blocks_fn blocks = sha1_accel();
+    if (blocks) {
+        blocks(state.h, (const uint8_t *)state.w, 1);
+        return;
+    }
+
     uint8_t index;
 
     // Convert the first 16 words from big endian to host byte order.
     for (index = 0; index < 16; ++index)
-        state.w[index] = be32toh(state.w[index]);
+        state.w[index] = bswap32(state.w[index]);
 
     // Initialize the hash value for this chunk.
     uint32_t a = state.h[0];
@@ -173,10 +197,10 @@ void SHA1::processChunk()
     // Perform the first 16 rounds of the compression function main loop.
     uint32_t temp;
     for (index = 0; index < 16; ++index) {
-        temp = leftRotate5(a) + ((b & c) | ((~b) & d)) + e + 0x5A827999 + state.w[index];
+        temp = rotl32(a, 5) + ((b & c) | ((~b) & d)) + e + 0x5A827999 + state.w[index];
         e = d;
         d = c;
-        c = leftRotate30(b);
+        c = rotl32(b, 30);
         b = a;
         a = temp;
     }
@@ -185,46 +209,46 @@ void SHA1::processChunk()
     // 80 in-place in the "w" array.  This saves 256 bytes of memory
     // that would have otherwise need to be allocated to the "w" array.
     for (; index < 20; ++index) {
-        temp = state.w[index & 0x0F] = leftRotate1
+        temp = state.w[index & 0x0F] = rotl32
             (state.w[(index - 3) & 0x0F] ^ state.w[(index - 8) & 0x0F] ^
-             state.w[(index - 14) & 0x0F] ^ state.w[(index - 16) & 0x0F]);
-        temp = leftRotate5(a) + ((b & c) | ((~b) & d)) + e + 0x5A827999 + temp;
+             state.w[(index - 14) & 0x0F] ^ state.w[(index - 16) & 0x0F], 1);
+        temp = rotl32(a, 5) + ((b & c) | ((~b) & d)) + e + 0x5A827999 + temp;
         e = d;
         d = c;
-        c = leftRotate30(b);
+        c = rotl32(b, 30);
         b = a;
         a = temp;
     }
     for (; index < 40; ++index) {
-        temp = state.w[index & 0x0F] = leftRotate1
+        temp = state.w[index & 0x0F] = rotl32
             (state.w[(index - 3) & 0x0F] ^ state.w[(index - 8) & 0x0F] ^
-             state.w[(index - 14) & 0x0F] ^ state.w[(index - 16) & 0x0F]);
-        temp = leftRotate5(a) + (b ^ c ^ d) + e + 0x6ED9EBA1 + temp;
+             state.w[(index - 14) & 0x0F] ^ state.w[(index - 16) & 0x0F], 1);
+        temp = rotl32(a, 5) + (b ^ c ^ d) + e + 0x6ED9EBA1 + temp;
         e = d;
         d = c;
-        c = leftRotate30(b);
+        c = rotl32(b, 30);
         b = a;
         a = temp;
     }
     for (; index < 60; ++index) {
-        temp = state.w[index & 0x0F] = leftRotate1
+        temp = state.w[index & 0x0F] = rotl32
             (state.w[(index - 3) & 0x0F] ^ state.w[(index - 8) & 0x0F] ^
-             state.w[(index - 14) & 0x0F] ^ state.w[(index - 16) & 0x0F]);
-        temp = leftRotate5(a) + ((b & c) | (b & d) | (c & d)) + e + 0x8F1BBCDC + temp;
+             state.w[(index - 14) & 0x0F] ^ state.w[(index - 16) & 0x0F], 1);
+        temp = rotl32(a, 5) + ((b & c) | (b & d) | (c & d)) + e + 0x8F1BBCDC + temp;
         e = d;
         d = c;
-        c = leftRotate30(b);
+        c = rotl32(b, 30);
         b = a;
         a = temp;
     }
     for (; index < 80; ++index) {
-        temp = state.w[index & 0x0F] = leftRotate1
+        temp = state.w[index & 0x0F] = rotl32
             (state.w[(index - 3) & 0x0F] ^ state.w[(index - 8) & 0x0F] ^
-             state.w[(index - 14) & 0x0F] ^ state.w[(index - 16) & 0x0F]);
-        temp = leftRotate5(a) + (b ^ c ^ d) + e + 0xCA62C1D6 + temp;
+             state.w[(index - 14) & 0x0F] ^ state.w[(index - 16) & 0x0F], 1);
+        temp = rotl32(a, 5) + (b ^ c ^ d) + e + 0xCA62C1D6 + temp;
         e = d;
         d = c;
-        c = leftRotate30(b);
+        c = rotl32(b, 30);
         b = a;
         a = temp;
     }
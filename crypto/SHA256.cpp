@@ -22,11 +22,19 @@
 
 #include "SHA256.h"
 #include "Crypto.h"
-#include "utility/RotateUtil.h"
-#include "utility/EndianUtil.h"
-#include "utility/ProgMemUtil.h"
+#include "utility/Intrinsics.h"
+#include "SHAAccel.h"
 #include <string.h>
 
+// Accelerated compression function for this CPU, or 0 to use the portable processChunk()
+static sha_blocks_fn sha256_accel()
+{
+    static const sha_blocks_fn blocks = shani_available() ? shani_sha256_blocks :
+                                          (ssse3_sha_available() ? ssse3_sha256_blocks : 0);   // Selected once (thread-safe initialization)
+
+    return blocks;
+}
+
 /**
  * \class SHA256 SHA256.h <SHA256.h>
  * \brief SHA-256 hash algorithm.
@@ -84,7 +92,16 @@ void SHA256::update(const void *data, size_t len)
 
     // Break the input up into 512-bit chunks and process each in turn.
     const uint8_t *d = (const uint8_t *)data;
+    sha_blocks_fn blocks = sha256_accel();
     while (len > 0) {
+        // Whole blocks can be compressed straight from the caller's buffer.
+        if (blocks && state.chunkSize == 0 && len >= 64) {
+            size_t count = len / 64;
+            blocks(state.h, d, count);
+            len -= count * 64;
+            d += count * 64;
+            continue;
+        }
         uint8_t size = 64 - state.chunkSize;
         if (size > len)
             size = len;
@@ -107,22 +124,22 @@ void SHA256::finalize(void *hash, size_t len)
     if (state.chunkSize <= (64 - 9)) {
         wbytes[state.chunkSize] = 0x80;
         memset(wbytes + state.chunkSize + 1, 0x00, 64 - 8 - (state.chunkSize + 1));
-        state.w[14] = htobe32((uint32_t)(state.length >> 32));
-        state.w[15] = htobe32((uint32_t)state.length);
+        state.w[14] = bswap32((uint32_t)(state.length >> 32));
+        state.w[15] = bswap32((uint32_t)state.length);
         processChunk();
     } else {
         wbytes[state.chunkSize] = 0x80;
         memset(wbytes + state.chunkSize + 1, 0x00, 64 - (state.chunkSize + 1));
         processChunk();
         memset(wbytes, 0x00, 64 - 8);
-        state.w[14] = htobe32((uint32_t)(state.length >> 32));
-        state.w[15] = htobe32((uint32_t)state.length);
+        state.w[14] = bswap32((uint32_t)(state.length >> 32));
+        state.w[15] = bswap32((uint32_t)state.length);
         processChunk();
     }
 
     // Convert the result into big endian and return it.
     for (uint8_t posn = 0; posn < 8; ++posn)
-        state.w[posn] = htobe32(state.h[posn]);
+        state.w[posn] = bswap32(state.h[posn]);
 
     // Copy the hash to the caller's return buffer.
     if (len > 32)
@@ -162,8 +179,14 @@ void SHA256::finalizeHMAC(const void *key, size_t keyLen, void *hash, size_t has
  */
 void SHA256::processChunk()
 {
+    sha_blocks_fn blocks = sha256_accel();
+    if (blocks) {
+        blocks(state.h, (const uint8_t *)state.w, 1);
+        return;
+    }
+
     // Round constants for SHA-256.
-    static uint32_t const k[64] PROGMEM = {
+    static uint32_t const k[64] = {
         0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
         0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
         0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
@@ -185,7 +208,7 @@ void SHA256::processChunk()
     // Convert the first 16 words from big endian to host byte order.
     uint8_t index;
     for (index = 0; index < 16; ++index)
-        state.w[index] = be32toh(state.w[index]);
+        state.w[index] = bswap32(state.w[index]);
 
     // Initialise working variables to the current hash value.
     uint32_t a = state.h[0];
@@ -200,10 +223,10 @@ void SHA256::processChunk()
     // Perform the first 16 rounds of the compression function main loop.
     uint32_t temp1, temp2;
     for (index = 0; index < 16; ++index) {
-        temp1 = h + pgm_read_dword(k + index) + state.w[index] +
-                (rightRotate6(e) ^ rightRotate11(e) ^ rightRotate25(e)) +
+        temp1 = h + k[index] + state.w[index] +
+                (rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25)) +
                 ((e & f) ^ ((~e) & g));
-        temp2 = (rightRotate2(a) ^ rightRotate13(a) ^ rightRotate22(a)) +
+        temp2 = (rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22)) +
                 ((a & b) ^ (a & c) ^ (b & c));
         h = g;
         g = f;
@@ -224,14 +247,14 @@ void SHA256::processChunk()
         temp2 = state.w[(index - 2) & 0x0F];
         temp1 = state.w[index & 0x0F] =
             state.w[(index - 16) & 0x0F] + state.w[(index - 7) & 0x0F] +
-                (rightRotate7(temp1) ^ rightRotate18(temp1) ^ (temp1 >> 3)) +
-                (rightRotate17(temp2) ^ rightRotate19(temp2) ^ (temp2 >> 10));
+                (rotr32(temp1, 7) ^ rotr32(temp1, 18) ^ (temp1 >> 3)) +
+                (rotr32(temp2, 17) ^ rotr32(temp2, 19) ^ (temp2 >> 10));
 
         // Perform the round.
-        temp1 = h + pgm_read_dword(k + index) + temp1 +
-                (rightRotate6(e) ^ rightRotate11(e) ^ rightRotate25(e)) +
+        temp1 = h + k[index] + temp1 +
+                (rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25)) +
                 ((e & f) ^ ((~e) & g));
-        temp2 = (rightRotate2(a) ^ rightRotate13(a) ^ rightRotate22(a)) +
+        temp2 = (rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22)) +
                 ((a & b) ^ (a & c) ^ (b & c));
         h = g;
         g = f;
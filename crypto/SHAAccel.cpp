@@ -0,0 +1,514 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include "crypto/SHAAccel.h"
+#include "crypto/Crypto.h"
+
+#if defined(CRYPTO_SHA_X86)
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <smmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SHANI_TARGET
+#define SSSE3_TARGET
+#else
+#include <cpuid.h>
+#define SHANI_TARGET __attribute__((target("sha,sse4.1,ssse3,sse2")))
+#define SSSE3_TARGET __attribute__((target("ssse3,sse2")))
+#endif
+
+
+// SHA-256 round constants (FIPS 180-4, 4.2.2), aligned for 128 bit loads
+alignas(16) static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+
+static void sha_cpuid(bool *shani, bool *ssse3)
+{
+// CPUID leaf 1, ECX bit 9: SSSE3, bit 19: SSE4.1 - leaf 7, EBX bit 29: SHA extensions
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    int maxLeaf = regs[0];
+    __cpuid(regs, 1);
+    unsigned int ecx = regs[2];
+    unsigned int ebx7 = 0;
+    if (maxLeaf >= 7) {
+        __cpuidex(regs, 7, 0);
+        ebx7 = regs[1];
+    }
+#else
+    unsigned int eax, ebx, ecx, edx;
+    unsigned int eax7, ebx7 = 0, ecx7, edx7;
+    *shani = *ssse3 = false;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return;
+    if (__get_cpuid_max(0, 0) >= 7)
+        __cpuid_count(7, 0, eax7, ebx7, ecx7, edx7);
+#endif
+    *ssse3 = (ecx & (1 << 9)) != 0;
+    *shani = *ssse3 && (ecx & (1 << 19)) != 0 && (ebx7 & (1 << 29)) != 0;
+}
+
+
+// SHA-256, four rounds: the message words of the group are in m (host order), the sha256rnds2 pairs them up with the state
+#define SHANI_SHA256_ROUNDS(g, m) \
+    do { \
+        msg = _mm_add_epi32(m, _mm_load_si128((const __m128i*) (sha256_k + 4 * (g)))); \
+        state1 = _mm_sha256rnds2_epu32(state1, state0, msg); \
+        msg = _mm_shuffle_epi32(msg, 0x0e); \
+        state0 = _mm_sha256rnds2_epu32(state0, state1, msg); \
+    } while (0)
+
+// Message schedule: completes the words of group g+1 (msg2) and starts those of group g+3 (msg1)
+#define SHANI_SHA256_MSG2(next, cur, prev) \
+    do { \
+        next = _mm_add_epi32(next, _mm_alignr_epi8(cur, prev, 4)); \
+        next = _mm_sha256msg2_epu32(next, cur); \
+    } while (0)
+#define SHANI_SHA256_MSG1(older, cur) \
+    do { \
+        older = _mm_sha256msg1_epu32(older, cur); \
+    } while (0)
+
+
+SHANI_TARGET void shani_sha256_blocks(uint32_t *state, const uint8_t *data, size_t count)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i state0, state1, save0, save1, msg, tmp;
+    __m128i m0, m1, m2, m3;
+
+    // The rounds instruction wants the state as (A, B, E, F) and (C, D, G, H)
+    tmp    = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) state), 0xb1);          // C D A B
+    state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) (state + 4)), 0x1b);    // E F G H
+    state0 = _mm_alignr_epi8(tmp, state1, 8);                                           // A B E F
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);                                        // C D G H
+
+    while (count > 0) {
+        save0 = state0;
+        save1 = state1;
+
+        m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data +  0)), mask);
+        m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 16)), mask);
+        m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 32)), mask);
+        m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 48)), mask);
+
+        SHANI_SHA256_ROUNDS(0, m0);
+        SHANI_SHA256_ROUNDS(1, m1);   SHANI_SHA256_MSG1(m0, m1);
+        SHANI_SHA256_ROUNDS(2, m2);   SHANI_SHA256_MSG1(m1, m2);
+        SHANI_SHA256_ROUNDS(3, m3);   SHANI_SHA256_MSG2(m0, m3, m2);   SHANI_SHA256_MSG1(m2, m3);
+        SHANI_SHA256_ROUNDS(4, m0);   SHANI_SHA256_MSG2(m1, m0, m3);   SHANI_SHA256_MSG1(m3, m0);
+        SHANI_SHA256_ROUNDS(5, m1);   SHANI_SHA256_MSG2(m2, m1, m0);   SHANI_SHA256_MSG1(m0, m1);
+        SHANI_SHA256_ROUNDS(6, m2);   SHANI_SHA256_MSG2(m3, m2, m1);   SHANI_SHA256_MSG1(m1, m2);
+        SHANI_SHA256_ROUNDS(7, m3);   SHANI_SHA256_MSG2(m0, m3, m2);   SHANI_SHA256_MSG1(m2, m3);
+        SHANI_SHA256_ROUNDS(8, m0);   SHANI_SHA256_MSG2(m1, m0, m3);   SHANI_SHA256_MSG1(m3, m0);
+        SHANI_SHA256_ROUNDS(9, m1);   SHANI_SHA256_MSG2(m2, m1, m0);   SHANI_SHA256_MSG1(m0, m1);
+        SHANI_SHA256_ROUNDS(10, m2);  SHANI_SHA256_MSG2(m3, m2, m1);   SHANI_SHA256_MSG1(m1, m2);
+        SHANI_SHA256_ROUNDS(11, m3);  SHANI_SHA256_MSG2(m0, m3, m2);   SHANI_SHA256_MSG1(m2, m3);
+        SHANI_SHA256_ROUNDS(12, m0);  SHANI_SHA256_MSG2(m1, m0, m3);   SHANI_SHA256_MSG1(m3, m0);
+        SHANI_SHA256_ROUNDS(13, m1);  SHANI_SHA256_MSG2(m2, m1, m0);
+        SHANI_SHA256_ROUNDS(14, m2);  SHANI_SHA256_MSG2(m3, m2, m1);
+        SHANI_SHA256_ROUNDS(15, m3);
+
+        state0 = _mm_add_epi32(state0, save0);
+        state1 = _mm_add_epi32(state1, save1);
+        data  += 64;
+        count -= 1;
+    }
+
+    tmp    = _mm_shuffle_epi32(state0, 0x1b);                                           // F E B A
+    state1 = _mm_shuffle_epi32(state1, 0xb1);                                           // D C H G
+    _mm_storeu_si128((__m128i*) state, _mm_blend_epi16(tmp, state1, 0xf0));           // D C B A
+    _mm_storeu_si128((__m128i*) (state + 4), _mm_alignr_epi8(state1, tmp, 8));         // H G F E
+
+    m0 = m1 = m2 = m3 = msg = _mm_setzero_si128();
+}
+
+
+// SHA-1, four rounds: e holds E plus the message words of the group, the round function selector f changes every 20 rounds
+#define SHANI_SHA1_ROUNDS(e, eNext, m, f) \
+    do { \
+        e = _mm_sha1nexte_epu32(e, m); \
+        eNext = abcd; \
+        abcd = _mm_sha1rnds4_epu32(abcd, e, f); \
+    } while (0)
+
+// Message schedule: completes group g+1 (msg2), continues group g+2 (xor) and starts group g+3 (msg1)
+#define SHANI_SHA1_MSG2(next, cur)          do { next = _mm_sha1msg2_epu32(next, cur); } while (0)
+#define SHANI_SHA1_MSG1(older, second, cur) \
+    do { \
+        older = _mm_sha1msg1_epu32(older, cur); \
+        second = _mm_xor_si128(second, cur); \
+    } while (0)
+
+
+SHANI_TARGET void shani_sha1_blocks(uint32_t *state, const uint8_t *data, size_t count)
+{
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+    __m128i abcd, saveAbcd, e0, e1, saveE;
+    __m128i m0, m1, m2, m3;
+
+    abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) state), 0x1b);
+    e0   = _mm_set_epi32((int) state[4], 0, 0, 0);
+
+    while (count > 0) {
+        saveAbcd = abcd;
+        saveE = e0;
+
+        m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data +  0)), mask);
+        m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 16)), mask);
+        m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 32)), mask);
+        m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 48)), mask);
+
+        // Rounds 0-3 add E directly, there is no previous ABCD to derive it from
+        e0 = _mm_add_epi32(e0, m0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        SHANI_SHA1_ROUNDS(e1, e0, m1, 0);                              m0 = _mm_sha1msg1_epu32(m0, m1);
+        SHANI_SHA1_ROUNDS(e0, e1, m2, 0);                              SHANI_SHA1_MSG1(m1, m0, m2);
+        SHANI_SHA1_ROUNDS(e1, e0, m3, 0);   SHANI_SHA1_MSG2(m0, m3);   SHANI_SHA1_MSG1(m2, m1, m3);
+        SHANI_SHA1_ROUNDS(e0, e1, m0, 0);   SHANI_SHA1_MSG2(m1, m0);   SHANI_SHA1_MSG1(m3, m2, m0);
+        SHANI_SHA1_ROUNDS(e1, e0, m1, 1);   SHANI_SHA1_MSG2(m2, m1);   SHANI_SHA1_MSG1(m0, m3, m1);
+        SHANI_SHA1_ROUNDS(e0, e1, m2, 1);   SHANI_SHA1_MSG2(m3, m2);   SHANI_SHA1_MSG1(m1, m0, m2);
+        SHANI_SHA1_ROUNDS(e1, e0, m3, 1);   SHANI_SHA1_MSG2(m0, m3);   SHANI_SHA1_MSG1(m2, m1, m3);
+        SHANI_SHA1_ROUNDS(e0, e1, m0, 1);   SHANI_SHA1_MSG2(m1, m0);   SHANI_SHA1_MSG1(m3, m2, m0);
+        SHANI_SHA1_ROUNDS(e1, e0, m1, 1);   SHANI_SHA1_MSG2(m2, m1);   SHANI_SHA1_MSG1(m0, m3, m1);
+        SHANI_SHA1_ROUNDS(e0, e1, m2, 2);   SHANI_SHA1_MSG2(m3, m2);   SHANI_SHA1_MSG1(m1, m0, m2);
+        SHANI_SHA1_ROUNDS(e1, e0, m3, 2);   SHANI_SHA1_MSG2(m0, m3);   SHANI_SHA1_MSG1(m2, m1, m3);
+        SHANI_SHA1_ROUNDS(e0, e1, m0, 2);   SHANI_SHA1_MSG2(m1, m0);   SHANI_SHA1_MSG1(m3, m2, m0);
+        SHANI_SHA1_ROUNDS(e1, e0, m1, 2);   SHANI_SHA1_MSG2(m2, m1);   SHANI_SHA1_MSG1(m0, m3, m1);
+        SHANI_SHA1_ROUNDS(e0, e1, m2, 2);   SHANI_SHA1_MSG2(m3, m2);   SHANI_SHA1_MSG1(m1, m0, m2);
+        SHANI_SHA1_ROUNDS(e1, e0, m3, 3);   SHANI_SHA1_MSG2(m0, m3);   SHANI_SHA1_MSG1(m2, m1, m3);
+        SHANI_SHA1_ROUNDS(e0, e1, m0, 3);   SHANI_SHA1_MSG2(m1, m0);   SHANI_SHA1_MSG1(m3, m2, m0);
+        SHANI_SHA1_ROUNDS(e1, e0, m1, 3);   SHANI_SHA1_MSG2(m2, m1);   m3 = _mm_xor_si128(m3, m1);
+        SHANI_SHA1_ROUNDS(e0, e1, m2, 3);   SHANI_SHA1_MSG2(m3, m2);
+        SHANI_SHA1_ROUNDS(e1, e0, m3, 3);
+
+        e0   = _mm_sha1nexte_epu32(e0, saveE);
+        abcd = _mm_add_epi32(abcd, saveAbcd);
+        data  += 64;
+        count -= 1;
+    }
+
+    _mm_storeu_si128((__m128i*) state, _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = (uint32_t) _mm_extract_epi32(e0, 3);
+
+    m0 = m1 = m2 = m3 = _mm_setzero_si128();
+}
+
+
+SSSE3_TARGET static inline __m128i ssse3_ror(__m128i x, int n)
+{
+    return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - n));
+}
+
+SSSE3_TARGET static inline __m128i ssse3_sigma1(__m128i x)
+{
+    return _mm_xor_si128(_mm_xor_si128(ssse3_ror(x, 17), ssse3_ror(x, 19)), _mm_srli_epi32(x, 10));
+}
+
+// Next four schedule words W[t..t+3] from w0 = W[t-16..t-13] ... w3 = W[t-4..t-1]
+SSSE3_TARGET static inline __m128i ssse3_sha256_schedule(__m128i w0, __m128i w1, __m128i w2, __m128i w3)
+{
+    __m128i s0, t;
+
+    s0 = _mm_alignr_epi8(w1, w0, 4);                                                     // W[t-15..t-12]
+    s0 = _mm_xor_si128(_mm_xor_si128(ssse3_ror(s0, 7), ssse3_ror(s0, 18)), _mm_srli_epi32(s0, 3));
+    t  = _mm_add_epi32(_mm_add_epi32(w0, s0), _mm_alignr_epi8(w3, w2, 4));               // + W[t-7..t-4]
+
+    // sigma1 needs W[t-2] and W[t-1]: the first two words use w3, the last two the words just computed
+    t = _mm_add_epi32(t, ssse3_sigma1(_mm_srli_si128(w3, 8)));
+    t = _mm_add_epi32(t, ssse3_sigma1(_mm_slli_si128(t, 8)));
+    return t;
+}
+
+#define SSSE3_ROR(x, n)  (((x) >> (n)) | ((x) << (32 - (n))))
+
+SSSE3_TARGET void ssse3_sha256_blocks(uint32_t *state, const uint8_t *data, size_t count)
+{
+// SIMD message schedule (W + K for all 64 rounds), compression rounds in scalar code
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    alignas(16) uint32_t wk[64];
+    __m128i w0, w1, w2, w3, w4;
+    uint32_t a, b, c, d, e, f, g, h, temp1, temp2;
+    int t;
+
+    while (count > 0) {
+        w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data +  0)), mask);
+        w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 16)), mask);
+        w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 32)), mask);
+        w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 48)), mask);
+        _mm_store_si128((__m128i*) (wk +  0), _mm_add_epi32(w0, _mm_load_si128((const __m128i*) (sha256_k +  0))));
+        _mm_store_si128((__m128i*) (wk +  4), _mm_add_epi32(w1, _mm_load_si128((const __m128i*) (sha256_k +  4))));
+        _mm_store_si128((__m128i*) (wk +  8), _mm_add_epi32(w2, _mm_load_si128((const __m128i*) (sha256_k +  8))));
+        _mm_store_si128((__m128i*) (wk + 12), _mm_add_epi32(w3, _mm_load_si128((const __m128i*) (sha256_k + 12))));
+        for (t = 16; t < 64; t += 4) {
+            w4 = ssse3_sha256_schedule(w0, w1, w2, w3);
+            _mm_store_si128((__m128i*) (wk + t), _mm_add_epi32(w4, _mm_load_si128((const __m128i*) (sha256_k + t))));
+            w0 = w1;
+            w1 = w2;
+            w2 = w3;
+            w3 = w4;
+        }
+
+        a = state[0];
+        b = state[1];
+        c = state[2];
+        d = state[3];
+        e = state[4];
+        f = state[5];
+        g = state[6];
+        h = state[7];
+        for (t = 0; t < 64; t++) {
+            temp1 = h + wk[t] + (SSSE3_ROR(e, 6) ^ SSSE3_ROR(e, 11) ^ SSSE3_ROR(e, 25)) + ((e & f) ^ ((~e) & g));
+            temp2 = (SSSE3_ROR(a, 2) ^ SSSE3_ROR(a, 13) ^ SSSE3_ROR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+
+        data  += 64;
+        count -= 1;
+    }
+
+    clean(wk);
+    w0 = w1 = w2 = w3 = w4 = _mm_setzero_si128();
+    a = b = c = d = e = f = g = h = temp1 = temp2 = 0;
+}
+
+
+
+SSSE3_TARGET static inline __m128i ssse3_rol(__m128i x, int n)
+{
+    return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n));
+}
+
+// Next four SHA-1 schedule words W[t..t+3] from w0 = W[t-16..t-13] ... w3 = W[t-4..t-1]
+SSSE3_TARGET static inline __m128i ssse3_sha1_schedule(__m128i w0, __m128i w1, __m128i w2, __m128i w3)
+{
+    __m128i t, r;
+
+    t = _mm_xor_si128(w0, _mm_alignr_epi8(w1, w0, 8));                                  // W[t-16..] ^ W[t-14..]
+    t = _mm_xor_si128(t, w2);                                                            // ^ W[t-8..]
+    t = _mm_xor_si128(t, _mm_srli_si128(w3, 4));                                         // ^ W[t-3..t-1], 0
+    r = ssse3_rol(t, 1);
+
+    // W[t+3] needs W[t], which is computed in the same vector: rol1(x ^ rol1(y)) = rol1(x) ^ rol2(y)
+    return _mm_xor_si128(r, ssse3_rol(_mm_slli_si128(t, 12), 2));
+}
+
+#define SSSE3_ROL(x, n)  (((x) << (n)) | ((x) >> (32 - (n))))
+
+SSSE3_TARGET void ssse3_sha1_blocks(uint32_t *state, const uint8_t *data, size_t count)
+{
+// SIMD message schedule (W + K for all 80 rounds), compression rounds in scalar code
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    const __m128i k[4] = {
+        _mm_set1_epi32(0x5a827999), _mm_set1_epi32(0x6ed9eba1), _mm_set1_epi32((int) 0x8f1bbcdc), _mm_set1_epi32((int) 0xca62c1d6)
+    };
+    alignas(16) uint32_t wk[80];
+    __m128i w0, w1, w2, w3, w4;
+    uint32_t a, b, c, d, e, temp;
+    int t;
+
+    while (count > 0) {
+        w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data +  0)), mask);
+        w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 16)), mask);
+        w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 32)), mask);
+        w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 48)), mask);
+        _mm_store_si128((__m128i*) (wk +  0), _mm_add_epi32(w0, k[0]));
+        _mm_store_si128((__m128i*) (wk +  4), _mm_add_epi32(w1, k[0]));
+        _mm_store_si128((__m128i*) (wk +  8), _mm_add_epi32(w2, k[0]));
+        _mm_store_si128((__m128i*) (wk + 12), _mm_add_epi32(w3, k[0]));
+        for (t = 16; t < 80; t += 4) {
+            w4 = ssse3_sha1_schedule(w0, w1, w2, w3);
+            _mm_store_si128((__m128i*) (wk + t), _mm_add_epi32(w4, k[t / 20]));
+            w0 = w1;
+            w1 = w2;
+            w2 = w3;
+            w3 = w4;
+        }
+
+        a = state[0];
+        b = state[1];
+        c = state[2];
+        d = state[3];
+        e = state[4];
+        for (t = 0; t < 80; t++) {
+            if (t < 20)
+                temp = (b & c) | ((~b) & d);
+            else if (t < 40 || t >= 60)
+                temp = b ^ c ^ d;
+            else
+                temp = (b & c) | (b & d) | (c & d);
+            temp += SSSE3_ROL(a, 5) + e + wk[t];
+            e = d;
+            d = c;
+            c = SSSE3_ROL(b, 30);
+            b = a;
+            a = temp;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+
+        data  += 64;
+        count -= 1;
+    }
+
+    clean(wk);
+    w0 = w1 = w2 = w3 = w4 = _mm_setzero_si128();
+    a = b = c = d = e = temp = 0;
+}
+
+
+// Pads a short message to whole blocks (FIPS 180-4, 5.1.1), returns the number of blocks
+static size_t sha_pad(uint8_t *blocks, const char *message)
+{
+    size_t len = strlen(message);
+    size_t count = (len + 9 + 63) / 64;
+    uint64_t bits = (uint64_t) len * 8;
+    int i;
+
+    memset(blocks, 0, count * 64);
+    memcpy(blocks, message, len);
+    blocks[len] = 0x80;
+    for (i = 0; i < 8; i++)
+        blocks[count * 64 - 1 - i] = (uint8_t) (bits >> (8 * i));
+    return count;
+}
+
+static bool sha256_selftest(sha_blocks_fn blocks)
+{
+// FIPS 180 examples: "abc" (one block) and the 448 bit message (two blocks)
+    static const uint32_t iv[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    static const uint32_t digest1[8] = {
+        0xba7816bf, 0x8f01cfea, 0x414140de, 0x5dae2223, 0xb00361a3, 0x96177a9c, 0xb410ff61, 0xf20015ad
+    };
+    static const uint32_t digest2[8] = {
+        0x248d6a61, 0xd20638b8, 0xe5c02693, 0x0c3e6039, 0xa33ce459, 0x64ff2167, 0xf6ecedd4, 0x19db06c1
+    };
+    uint8_t buffer[128];
+    uint32_t state[8];
+    bool ok;
+
+    memcpy(state, iv, sizeof(state));
+    blocks(state, buffer, sha_pad(buffer, "abc"));
+    ok = (memcmp(state, digest1, sizeof(state)) == 0);
+
+    memcpy(state, iv, sizeof(state));
+    blocks(state, buffer, sha_pad(buffer, "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"));
+    ok = ok && (memcmp(state, digest2, sizeof(state)) == 0);
+
+    return ok;
+}
+
+static bool sha1_selftest(sha_blocks_fn blocks)
+{
+// FIPS 180 examples, as above
+    static const uint32_t iv[5] = {
+        0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
+    };
+    static const uint32_t digest1[5] = {
+        0xa9993e36, 0x4706816a, 0xba3e2571, 0x7850c26c, 0x9cd0d89d
+    };
+    static const uint32_t digest2[5] = {
+        0x84983e44, 0x1c3bd26e, 0xbaae4aa1, 0xf95129e5, 0xe54670f1
+    };
+    uint8_t buffer[128];
+    uint32_t state[5];
+    bool ok;
+
+    memcpy(state, iv, sizeof(state));
+    blocks(state, buffer, sha_pad(buffer, "abc"));
+    ok = (memcmp(state, digest1, sizeof(state)) == 0);
+
+    memcpy(state, iv, sizeof(state));
+    blocks(state, buffer, sha_pad(buffer, "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"));
+    ok = ok && (memcmp(state, digest2, sizeof(state)) == 0);
+
+    return ok;
+}
+
+
+bool shani_available()
+{
+    static const bool available = []() {    // Checked once (thread-safe initialization)
+        bool shani, ssse3;
+        sha_cpuid(&shani, &ssse3);
+        return shani && sha256_selftest(shani_sha256_blocks) && sha1_selftest(shani_sha1_blocks);
+    }();
+
+    return available;
+}
+
+bool ssse3_sha_available()
+{
+    static const bool available = []() {
+        bool shani, ssse3;
+        sha_cpuid(&shani, &ssse3);
+        return ssse3 && sha256_selftest(ssse3_sha256_blocks) && sha1_selftest(ssse3_sha1_blocks);
+    }();
+
+    return available;
+}
+
+#else // CRYPTO_SHA_X86
+
+bool shani_available()
+{
+    return false;
+}
+
+bool ssse3_sha_available()
+{
+    return false;
+}
+
+void shani_sha256_blocks(uint32_t *, const uint8_t *, size_t) {}
+void shani_sha1_blocks(uint32_t *, const uint8_t *, size_t) {}
+void ssse3_sha256_blocks(uint32_t *, const uint8_t *, size_t) {}
+void ssse3_sha1_blocks(uint32_t *, const uint8_t *, size_t) {}
+
+#endif // CRYPTO_SHA_X86
@@ -0,0 +1,45 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SHAACCEL_H
+#define SHAACCEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// SHA-1 / SHA-256 compression functions using x86 SIMD instructions.
+// All functions process "count" consecutive 64-byte message blocks (big endian, as in the message) and update the
+// chaining state in host word order, i.e. the layout of the "h" array in SHA1 and SHA256.
+// SHA1 and SHA256 select an implementation at runtime and fall back to their portable processChunk().
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CRYPTO_SHA_X86 1
+#endif
+
+typedef void (*sha_blocks_fn)(uint32_t *state, const uint8_t *data, size_t count);
+
+// Returns true if the CPU supports the Intel SHA extensions (plus SSSE3/SSE4.1) and the implementation passed the
+// FIPS 180 known-answer tests. The check runs once, later calls return the cached result.
+bool shani_available();
+
+// Returns true if the CPU supports SSSE3 and the SIMD message schedules (SHA-256 and SHA-1) passed the known-answer tests.
+bool ssse3_sha_available();
+
+void shani_sha256_blocks(uint32_t *state, const uint8_t *data, size_t count);
+void shani_sha1_blocks(uint32_t *state, const uint8_t *data, size_t count);
+void ssse3_sha256_blocks(uint32_t *state, const uint8_t *data, size_t count);
+void ssse3_sha1_blocks(uint32_t *state, const uint8_t *data, size_t count);
+
+
+#endif // SHAACCEL_H
@@ -0,0 +1,146 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "crypto/SecureArena.h"
+#include "crypto/SecureMem.h"
+#include "crypto/Crypto.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#define ARENA_ALIGN      16
+#define ARENA_MIN_BLOCK  65536
+
+
+SecureArena::SecureArena()
+{
+}
+
+
+SecureArena::~SecureArena()
+{
+    release();
+}
+
+
+void *SecureArena::alloc(size_t len)
+{
+// Zeroed memory of len Bytes (16 Byte aligned), valid until the next reset() or release() - NULL if out of memory
+    uint8_t *base;
+    size_t   size;
+    Block    block;
+
+    len = (len + ARENA_ALIGN - 1) & ~(size_t) (ARENA_ALIGN - 1);
+    if (len == 0) len = ARENA_ALIGN;
+
+    if (!blocks.empty() && blocks.back().size - blocks.back().used >= len) {
+        base = blocks.back().base + blocks.back().used;
+        blocks.back().used += len;
+        return base;
+    }
+
+    // New block, at least twice the size of the last one so the no. of blocks stays small:
+    size = ARENA_MIN_BLOCK;
+    if (!blocks.empty() && blocks.back().size * 2 > size) size = blocks.back().size * 2;
+    if (len > size) size = len;
+    base = mapBlock(size);
+    if (base == NULL) return NULL;
+    block.base = base;
+    block.size = size;
+    block.used = len;
+    blocks.push_back(block);
+
+    return base;
+}
+
+
+void SecureArena::reset()
+{
+// Wipe all memory handed out (it is zero again for the next alloc())
+// Several blocks are merged into one, so the next round of the same allocations fits into a single block.
+    size_t total, i;
+
+    total = 0;
+    for (i = 0; i < blocks.size(); i++) {
+        clean(blocks[i].base, blocks[i].used);
+        blocks[i].used = 0;
+        total += blocks[i].size;
+    }
+    if (blocks.size() > 1) {
+        release();
+        Block block;
+        block.base = mapBlock(total);
+        block.size = total;
+        block.used = 0;
+        if (block.base != NULL) blocks.push_back(block);
+    }
+}
+
+
+void SecureArena::release()
+{
+// Wipe all memory and give it back to the OS
+    size_t i;
+
+    for (i = 0; i < blocks.size(); i++) {
+        clean(blocks[i].base, blocks[i].used);
+        unmapBlock(blocks[i].base, blocks[i].size);
+    }
+    blocks.clear();
+}
+
+
+size_t SecureArena::capacity() const
+{
+    size_t total, i;
+
+    total = 0;
+    for (i = 0; i < blocks.size(); i++) total += blocks[i].size;
+    return total;
+}
+
+
+uint8_t *SecureArena::mapBlock(size_t size)
+{
+// Page-aligned, zeroed memory straight from the OS (never shared with other heap data), locked into RAM if possible
+    void *base;
+
+#if defined(_WIN32)
+    base = VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (base == NULL) return NULL;
+#else
+    base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) return NULL;
+#if defined(MADV_DONTDUMP)
+    madvise(base, size, MADV_DONTDUMP);
+#endif
+#endif
+    secure_lock(base, size);   // Still usable if the OS refuses (e.g. RLIMIT_MEMLOCK)
+
+    return (uint8_t*) base;
+}
+
+
+void SecureArena::unmapBlock(uint8_t *base, size_t size)
+{
+    secure_unlock(base, size);
+#if defined(_WIN32)
+    VirtualFree(base, 0, MEM_RELEASE);
+#else
+    munmap(base, size);
+#endif
+}
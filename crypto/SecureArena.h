@@ -0,0 +1,50 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SECUREARENA_H
+#define SECUREARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Memory for plaintext & key material that is needed again and again (e.g. the buffers of every save).
+// alloc() hands out zeroed memory from page-locked blocks (see secure_lock()), which are also excluded from core dumps
+// where the OS supports it. reset() wipes everything handed out since the last reset() but keeps the memory for the
+// next round, so repeated saves don't allocate at all once the arena has grown to the size they need.
+// Not thread-safe: every thread needs its own arena.
+class SecureArena
+{
+public:
+    SecureArena();
+    ~SecureArena();
+
+    void  *alloc(size_t len);
+    void   reset();
+    void   release();
+    size_t capacity() const;
+
+private:
+    struct Block {
+        uint8_t *base;
+        size_t   size;
+        size_t   used;
+    };
+    std::vector<Block> blocks;
+
+    static uint8_t *mapBlock(size_t size);
+    static void     unmapBlock(uint8_t *base, size_t size);
+};
+
+#endif // SECUREARENA_H
@@ -0,0 +1,41 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "crypto/SecureMem.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+
+bool secure_lock(void *addr, size_t len)
+{
+#if defined(_WIN32)
+    return VirtualLock(addr, len) != 0;
+#else
+    return mlock(addr, len) == 0;
+#endif
+}
+
+
+void secure_unlock(void *addr, size_t len)
+{
+#if defined(_WIN32)
+    VirtualUnlock(addr, len);
+#else
+    munlock(addr, len);
+#endif
+}
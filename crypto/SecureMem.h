@@ -0,0 +1,29 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SECUREMEM_H
+#define SECUREMEM_H
+
+#include <stddef.h>
+
+// Pin a memory region holding key material into RAM so it is never written to swap.
+// Returns false if the OS refused (e.g. RLIMIT_MEMLOCK exceeded) - the memory is still usable then.
+bool secure_lock(void *addr, size_t len);
+
+// Release the lock taken with secure_lock(). The caller is responsible for wiping the memory first
+// (clean() for plain buffers, clear() for cipher objects).
+void secure_unlock(void *addr, size_t len);
+
+
+#endif // SECUREMEM_H
@@ -0,0 +1,40 @@
+# Timekeeper crypto: AES-256 (CBC, CTR, authenticated chunks), SHA-1/SHA-256, HMAC, PBKDF2 and locked key memory.
+# Plain C++ - no Qt modules needed. Used by the core and by the crypto tests (tests/crypto).
+
+SOURCES += \
+    $$PWD/AES256.cpp \
+    $$PWD/AESCommon.cpp \
+    $$PWD/AESNI.cpp \
+    $$PWD/BlockCipher.cpp \
+    $$PWD/CBC.cpp \
+    $$PWD/ChunkCipher.cpp \
+    $$PWD/Cipher.cpp \
+    $$PWD/Crypto.cpp \
+    $$PWD/CTR.cpp \
+    $$PWD/Hash.cpp \
+    $$PWD/pbkdf2.cpp \
+    $$PWD/SecureArena.cpp \
+    $$PWD/SecureMem.cpp \
+    $$PWD/SHA1.cpp \
+    $$PWD/SHA256.cpp \
+    $$PWD/SHAAccel.cpp
+
+HEADERS += \
+    $$PWD/utility/Intrinsics.h \
+    $$PWD/AES.h \
+    $$PWD/AESNI.h \
+    $$PWD/BlockCipher.h \
+    $$PWD/CBC.h \
+    $$PWD/ChunkCipher.h \
+    $$PWD/Cipher.h \
+    $$PWD/Crypto.h \
+    $$PWD/CTR.h \
+    $$PWD/Hash.h \
+    $$PWD/pbkdf2.h \
+    $$PWD/SecureArena.h \
+    $$PWD/SecureMem.h \
+    $$PWD/SHA1.h \
+    $$PWD/SHA256.h \
+    $$PWD/SHAAccel.h
+
+INCLUDEPATH += $$PWD/..
@@ -18,48 +18,60 @@ If not, see <https://www.gnu.org/licenses/>.
 #include <stdlib.h>
 #include "crypto/pbkdf2.h"
 #include "crypto/SHA1.h"
+#include "crypto/SHA256.h"
+#include "crypto/Crypto.h"
 
 // Adapted from: http://bxr.su/OpenBSD/lib/libutil/pkcs5_pbkdf2.c
 // (Apparently the best I could find...)
 
 /*
- * HMAC-SHA-1 (from RFC 2202).
+ * HMAC key pad states (RFC 2104).
+ * The inner and outer pads only depend on the password, so they are hashed once per derivation.
+ * Every PRF call then starts from a copy of these states and costs two compression function
+ * calls instead of four.
  */
-static void hmac_sha1(const uint8_t *text, size_t text_len, const uint8_t *key, size_t key_len, uint8_t digest[SHA1_DIGEST_LENGTH])
+template <typename T, size_t BLOCK_LENGTH, size_t DIGEST_LENGTH>
+static void hmac_init(T &inner, T &outer, const uint8_t *key, size_t key_len)
 {
-    uint8_t k_pad[SHA1_BLOCK_LENGTH];
-    uint8_t tk[SHA1_DIGEST_LENGTH];
-    int i;
-    SHA1 sha1;
-
-    if (key_len > SHA1_BLOCK_LENGTH) {
-        sha1.reset();
-        sha1.update(key, key_len);
-        sha1.finalize(tk, SHA1_DIGEST_LENGTH);
-
-        key = tk;
-        key_len = SHA1_DIGEST_LENGTH;
-    }
+    uint8_t k_pad[BLOCK_LENGTH];
+    size_t i;
 
+    // Zero-padded key, hashed first if longer than one block:
     memset(k_pad, 0, sizeof(k_pad));
-    memcpy(k_pad, key, key_len);
-    for (i = 0; i < SHA1_BLOCK_LENGTH; i++)
-        k_pad[i] ^= 0x36;
+    if (key_len > BLOCK_LENGTH) {
+        inner.reset();
+        inner.update(key, key_len);
+        inner.finalize(k_pad, DIGEST_LENGTH);
+    }
+    else {
+        memcpy(k_pad, key, key_len);
+    }
 
-    sha1.reset();
-    sha1.update(k_pad, SHA1_BLOCK_LENGTH);
-    sha1.update(text, text_len);
-    sha1.finalize(digest, SHA1_DIGEST_LENGTH);
+    // resetHMAC() XORs the key with 0x36 and hashes it, which is the inner state already.
+    inner.resetHMAC(k_pad, BLOCK_LENGTH);
 
-    memset(k_pad, 0, sizeof(k_pad));
-    memcpy(k_pad, key, key_len);
-    for (i = 0; i < SHA1_BLOCK_LENGTH; i++)
-        k_pad[i] ^= 0x5c;
-
-    sha1.reset();
-    sha1.update(k_pad, SHA1_BLOCK_LENGTH);
-    sha1.update(digest, SHA1_DIGEST_LENGTH);
-    sha1.finalize(digest, SHA1_DIGEST_LENGTH);
+    // For the outer state, hand resetHMAC() a key that comes out as key ^ 0x5c:
+    for (i = 0; i < BLOCK_LENGTH; i++)
+        k_pad[i] ^= 0x5c ^ 0x36;
+    outer.resetHMAC(k_pad, BLOCK_LENGTH);
+
+    clean(k_pad, sizeof(k_pad));
+}
+
+template <typename T, size_t DIGEST_LENGTH>
+static void hmac_compute(const T &inner, const T &outer, const uint8_t *text, size_t text_len, uint8_t digest[DIGEST_LENGTH])
+{
+    T ctx;
+
+    ctx = inner;
+    ctx.update(text, text_len);
+    ctx.finalize(digest, DIGEST_LENGTH);
+
+    ctx = outer;
+    ctx.update(digest, DIGEST_LENGTH);
+    ctx.finalize(digest, DIGEST_LENGTH);
+
+    ctx.clear();
 }
 
 
@@ -67,13 +79,18 @@ static void hmac_sha1(const uint8_t *text, size_t text_len, const uint8_t *key,
  * Password-Based Key Derivation Function 2 (PKCS #5 v2.0).
  * Code based on IEEE Std 802.11-2007, Annex H.4.2.
  */
-int pkcs5_pbkdf2(const uint8_t *pass, size_t pass_len, const uint8_t *salt, size_t salt_len, uint8_t *key, size_t key_len, unsigned int rounds)
+template <typename T, size_t BLOCK_LENGTH, size_t DIGEST_LENGTH>
+static int pbkdf2(const uint8_t *pass, size_t pass_len, const uint8_t *salt, size_t salt_len, uint8_t *key, size_t key_len, unsigned int rounds,
+                  pbkdf2_progress_cb progress, void *ctx)
 {
-    uint8_t *asalt, obuf[SHA1_DIGEST_LENGTH];
-    uint8_t d1[SHA1_DIGEST_LENGTH], d2[SHA1_DIGEST_LENGTH];
+    uint8_t *asalt, obuf[DIGEST_LENGTH];
+    uint8_t d1[DIGEST_LENGTH];
     unsigned int i, j;
     unsigned int count;
+    unsigned int total;
     size_t r;
+    int ret;
+    T inner, outer;
 
 
     if (rounds < 1 || key_len == 0) {
@@ -94,22 +111,34 @@ int pkcs5_pbkdf2(const uint8_t *pass, size_t pass_len, const uint8_t *salt, size
 
     memcpy(asalt, salt, salt_len);
 
-    for (count = 1; key_len > 0; count++) {
+    hmac_init<T, BLOCK_LENGTH, DIGEST_LENGTH>(inner, outer, pass, pass_len);
+
+    ret   = 0;
+    total = ((key_len + DIGEST_LENGTH - 1) / DIGEST_LENGTH) * rounds;
+
+    for (count = 1; key_len > 0 && ret == 0; count++) {
         asalt[salt_len + 0] = (count >> 24) & 0xff;
         asalt[salt_len + 1] = (count >> 16) & 0xff;
         asalt[salt_len + 2] = (count >> 8) & 0xff;
         asalt[salt_len + 3] = count & 0xff;
-        hmac_sha1(asalt, salt_len + 4, pass, pass_len, d1);
+        hmac_compute<T, DIGEST_LENGTH>(inner, outer, asalt, salt_len + 4, d1);
         memcpy(obuf, d1, sizeof(obuf));
 
         for (i = 1; i < rounds; i++) {
-            hmac_sha1(d1, sizeof(d1), pass, pass_len, d2);
-            memcpy(d1, d2, sizeof(d1));
+            hmac_compute<T, DIGEST_LENGTH>(inner, outer, d1, sizeof(d1), d1);
             for (j = 0; j < sizeof(obuf); j++)
                 obuf[j] ^= d1[j];
+            if (progress != NULL && (i % PBKDF2_PROGRESS_INTERVAL) == 0) {
+                if (progress(ctx, (count - 1) * rounds + i, total) != 0) {
+                    ret = -2;
+                    break;
+                }
+            }
         }
+        if (ret != 0)
+            break;
 
-        r = MINIMUM(key_len, SHA1_DIGEST_LENGTH);
+        r = MINIMUM(key_len, DIGEST_LENGTH);
         memcpy(key, obuf, r);
         key += r;
         key_len -= r;
@@ -117,10 +146,25 @@ int pkcs5_pbkdf2(const uint8_t *pass, size_t pass_len, const uint8_t *salt, size
 
     delete[] asalt;
 
-//    explicit_bzero(d1, sizeof(d1));
-//    explicit_bzero(d2, sizeof(d2));
-//    explicit_bzero(obuf, sizeof(obuf));
+    inner.clear();
+    outer.clear();
+    clean(d1, sizeof(d1));
+    clean(obuf, sizeof(obuf));
+
+    return ret;
+
+}
+
 
-    return 0;
+int pkcs5_pbkdf2(const uint8_t *pass, size_t pass_len, const uint8_t *salt, size_t salt_len, uint8_t *key, size_t key_len, unsigned int rounds,
+                 pbkdf2_progress_cb progress, void *ctx)
+{
+    return pbkdf2<SHA1, SHA1_BLOCK_LENGTH, SHA1_DIGEST_LENGTH>(pass, pass_len, salt, salt_len, key, key_len, rounds, progress, ctx);
+}
 
+
+int pkcs5_pbkdf2_sha256(const uint8_t *pass, size_t pass_len, const uint8_t *salt, size_t salt_len, uint8_t *key, size_t key_len, unsigned int rounds,
+                        pbkdf2_progress_cb progress, void *ctx)
+{
+    return pbkdf2<SHA256, SHA256_BLOCK_LENGTH, SHA256_DIGEST_LENGTH>(pass, pass_len, salt, salt_len, key, key_len, rounds, progress, ctx);
 }
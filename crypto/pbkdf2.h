@@ -18,9 +18,20 @@ If not, see <https://www.gnu.org/licenses/>.
 #define	MINIMUM(a,b) (((a) < (b)) ? (a) : (b))
 #define SHA1_BLOCK_LENGTH 64
 #define SHA1_DIGEST_LENGTH 20
-
-static void hmac_sha1(const uint8_t *text, size_t text_len, const uint8_t *key, size_t key_len, uint8_t digest[SHA1_DIGEST_LENGTH]);
-int pkcs5_pbkdf2(const uint8_t *pass, size_t pass_len, const uint8_t *salt, size_t salt_len, uint8_t *key, size_t key_len, unsigned int rounds);
+#define SHA256_BLOCK_LENGTH 64
+#define SHA256_DIGEST_LENGTH 32
+
+// Optional progress callback, called every PBKDF2_PROGRESS_INTERVAL iterations with the iterations done so far
+// and the total for the whole key. Returning non-zero aborts the derivation (pkcs5_pbkdf2 then returns -2).
+#define PBKDF2_PROGRESS_INTERVAL 256
+typedef int (*pbkdf2_progress_cb)(void *ctx, unsigned int done, unsigned int total);
+
+// PBKDF2 with HMAC-SHA1 as PRF (save file version 100)
+int pkcs5_pbkdf2(const uint8_t *pass, size_t pass_len, const uint8_t *salt, size_t salt_len, uint8_t *key, size_t key_len, unsigned int rounds,
+                 pbkdf2_progress_cb progress = NULL, void *ctx = NULL);
+// PBKDF2 with HMAC-SHA256 as PRF (save file version 101)
+int pkcs5_pbkdf2_sha256(const uint8_t *pass, size_t pass_len, const uint8_t *salt, size_t salt_len, uint8_t *key, size_t key_len, unsigned int rounds,
+                        pbkdf2_progress_cb progress = NULL, void *ctx = NULL);
 
 
 #endif // PBKDF2_H
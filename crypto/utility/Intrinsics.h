@@ -0,0 +1,126 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CRYPTO_INTRINSICS_H
+#define CRYPTO_INTRINSICS_H
+
+#include <stdint.h>
+#include <string.h>
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
+// Rotates, byte swaps and unaligned loads/stores for the crypto code (AES, SHA-1, SHA-256).
+// They replace the Arduino helpers (ProgMemUtil, RotateUtil, EndianUtil, LimbUtil), which were written around the
+// limitations of 8-bit AVR CPUs. The compilers turn these into single instructions (rol/ror, bswap/movbe, mov).
+// Little endian hosts are assumed, as before (x86, ARM).
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#error "The crypto code assumes a little endian CPU"
+#endif
+
+static inline uint32_t rotl32(uint32_t x, unsigned n)
+{
+#if defined(_MSC_VER)
+    return _rotl(x, n);
+#else
+    return (x << (n & 31)) | (x >> ((32 - n) & 31));
+#endif
+}
+
+static inline uint32_t rotr32(uint32_t x, unsigned n)
+{
+#if defined(_MSC_VER)
+    return _rotr(x, n);
+#else
+    return (x >> (n & 31)) | (x << ((32 - n) & 31));
+#endif
+}
+
+static inline uint64_t rotl64(uint64_t x, unsigned n)
+{
+#if defined(_MSC_VER)
+    return _rotl64(x, n);
+#else
+    return (x << (n & 63)) | (x >> ((64 - n) & 63));
+#endif
+}
+
+static inline uint64_t rotr64(uint64_t x, unsigned n)
+{
+#if defined(_MSC_VER)
+    return _rotr64(x, n);
+#else
+    return (x >> (n & 63)) | (x << ((64 - n) & 63));
+#endif
+}
+
+static inline uint32_t bswap32(uint32_t x)
+{
+#if defined(_MSC_VER)
+    return _byteswap_ulong(x);
+#else
+    return __builtin_bswap32(x);
+#endif
+}
+
+static inline uint64_t bswap64(uint64_t x)
+{
+#if defined(_MSC_VER)
+    return _byteswap_uint64(x);
+#else
+    return __builtin_bswap64(x);
+#endif
+}
+
+// Loads & stores of (possibly unaligned) big/little endian words
+static inline uint32_t load_be32(const uint8_t *p)
+{
+    uint32_t x;
+    memcpy(&x, p, 4);
+    return bswap32(x);
+}
+
+static inline void store_be32(uint8_t *p, uint32_t x)
+{
+    x = bswap32(x);
+    memcpy(p, &x, 4);
+}
+
+static inline uint64_t load_be64(const uint8_t *p)
+{
+    uint64_t x;
+    memcpy(&x, p, 8);
+    return bswap64(x);
+}
+
+static inline void store_be64(uint8_t *p, uint64_t x)
+{
+    x = bswap64(x);
+    memcpy(p, &x, 8);
+}
+
+static inline uint32_t load_le32(const uint8_t *p)
+{
+    uint32_t x;
+    memcpy(&x, p, 4);
+    return x;
+}
+
+static inline void store_le32(uint8_t *p, uint32_t x)
+{
+    memcpy(p, &x, 4);
+}
+
+#endif // CRYPTO_INTRINSICS_H
@@ -24,15 +24,53 @@ If not, see <https://www.gnu.org/licenses/>.
 #include <QObject>
 #include <QList>
 #include <QWindow>
+#include <string.h>
 
 #include "src/CTaskModel.h"
 #include "src/CTrayManager.h"
+#include "src/CHeadless.h"
+#include "src/CControlClient.h"
+#include "src/CModelBenchmark.h"
+#include "core/CTrace.h"
 
 
 int main(int argc, char *argv[])
 {
     CTrayManager *trayManager;
-
+    int ret;
+
+    // Trace spans (see CTrace), written at exit or from the tray menu:
+    if (!qEnvironmentVariableIsEmpty("TIMEKEEPER_TRACE")) CTrace::enable(qEnvironmentVariable("TIMEKEEPER_TRACE"));
+
+    // Command line modes (headless, control client, model benchmark), no GUI:
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            CTrace::enable(QString::fromLocal8Bit(argv[++i]));
+            continue;
+        }
+        if (strcmp(argv[i], "--headless") == 0) {
+            // Reports & CSV export on a QCoreApplication - no QML engine, tray icon or screen:
+            ret = CHeadless::run(argc, argv);
+            CTrace::dump();
+            return ret;
+        }
+        if (strcmp(argv[i], "--control") == 0) {
+            // Client of the control socket of a running instance:
+            QStringList args;
+            for (int k = i + 1; k < argc; k++) args << QString::fromLocal8Bit(argv[k]);
+            QCoreApplication app(argc, argv);
+            return CControlClient::run(args);
+        }
+        if (strcmp(argv[i], "--benchmark-model") == 0) {
+            // The core only needs an event loop for loading encrypted files, no display:
+            QStringList args;
+            for (int k = i + 1; k < argc; k++) args << QString::fromLocal8Bit(argv[k]);
+            QCoreApplication app(argc, argv);
+            ret = CModelBenchmark::run(args);
+            CTrace::dump();
+            return ret;
+        }
+    }
 
     QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
 
@@ -60,6 +98,9 @@ int main(int argc, char *argv[])
     // After the QML is loaded, finish initialization of tray manager:
     trayManager->setup(&app);
 
-    return app.exec();
+    ret = app.exec();
+    CTrace::dump();
+
+    return ret;
 
 }
@@ -101,6 +101,17 @@ ApplicationWindow {
 
     }
 
+    // Task started or stopped by a script through the control socket - same state as after a click in the task list:
+    Connections {
+        target: listView.model
+        onActiveTaskChanged: {
+            rowActive    = row;
+            activeTaskID = taskID;
+            counting     = (row===-1) ? 0 : 1;
+            TrayManager.updateIcon(counting===1 ? 0 : 1);   // Regular icon while counting, alert icon otherwise
+        }
+    }
+
     property int currentEntry: -1           // Index containing the current entry in the list
     property int counting: 0                // 1 if any task is currently counting time, 0 otherwise
     property int rowActive: -1              // Index containing the entry that is currently counting time
@@ -224,6 +235,10 @@ ApplicationWindow {
         id: saveFile
     }
 
+    ImportCsvDialog {
+        id: importCsv
+    }
+
 
 
 //  Top Menu  ////////////////////////////////////////////////////////////
@@ -0,0 +1,85 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <QLocalSocket>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include "CControlClient.h"
+#include "CControlServer.h"
+
+
+int CControlClient::run(const QStringList &args)
+{
+//  Send the commands given (or read from stdin) to the running instance & print the replies
+    QLocalSocket socket;
+    QElapsedTimer clock;
+    QStringList commands;
+    QByteArray request, replies;
+    QString line;
+    int     i, count, status;
+
+    for (i=0; i<args.count(); i++) {
+        if (!args.at(i).trimmed().isEmpty()) commands << args.at(i).trimmed();
+    }
+    if (commands.isEmpty()) {
+        QTextStream in(stdin);
+        while (!in.atEnd()) {
+            line = in.readLine().trimmed();
+            if (!line.isEmpty()) commands << line;
+        }
+    }
+    if (commands.isEmpty()) {
+        fprintf(stderr, "Usage: Timekeeper --control <command>...   (commands: ping, status, list, start <taskID>, stop, add <taskID> <seconds> [day], day [day])\n");
+        return 1;
+    }
+    for (i=0; i<commands.count(); i++) {
+        request.append(commands.at(i).toUtf8());
+        request.append('\n');
+    }
+
+    socket.connectToServer(CONTROL_SERVER_NAME);
+    if (!socket.waitForConnected(1000)) {
+        fprintf(stderr, "Timekeeper is not running (%s)\n", socket.errorString().toUtf8().data());
+        return 2;
+    }
+
+    // One write for all commands, then wait for one reply line per command:
+    clock.start();
+    socket.write(request);
+    socket.flush();
+    count = 0;
+    while (count < commands.count()) {
+        if (!socket.canReadLine() && !socket.waitForReadyRead(5000)) {
+            fprintf(stderr, "No reply from Timekeeper (%d of %d commands answered)\n", count, commands.count());
+            return 2;
+        }
+        while (socket.canReadLine()) {
+            replies.append(socket.readLine());
+            count++;
+        }
+    }
+    fprintf(stderr, "# %d command(s), round trip %.3f ms\n", commands.count(), clock.nsecsElapsed() / 1e6);
+    socket.disconnectFromServer();
+
+    // Print the replies:
+    status = 0;
+    for (const QByteArray &reply : replies.split('\n')) {
+        if (reply.isEmpty()) continue;
+        printf("%s\n", reply.data());
+        if (!reply.startsWith("OK")) status = 1;
+    }
+
+    return status;
+}
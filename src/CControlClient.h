@@ -0,0 +1,32 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CCONTROLCLIENT_H
+#define CCONTROLCLIENT_H
+
+#include <QStringList>
+
+// Client of the control socket ("Timekeeper --control <command>..."), for scripts and for trying the protocol by hand
+//
+// Each argument is one command (e.g. "start 3"); without arguments the commands are read from stdin, one per line.
+// All commands are sent at once and answered in one round trip (see CControlServer for the protocol). The replies
+// are printed to stdout, the round trip time to stderr. Exit code: 0 if all replies are "OK", 1 if any is an error,
+// 2 if Timekeeper is not running (or did not answer in time).
+class CControlClient
+{
+public:
+    static int run(const QStringList &args);
+};
+
+#endif // CCONTROLCLIENT_H
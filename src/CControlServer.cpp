@@ -0,0 +1,193 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <QList>
+#include <QDate>
+#include "CControlServer.h"
+#include "CTaskModel.h"
+#include "core/CTrace.h"
+
+
+CControlServer::CControlServer(CTaskModel &model, CLogger &logger, QObject *parent)
+    : QObject(parent), model(model), logger(logger)
+{
+    connect(&server, &QLocalServer::newConnection, this, &CControlServer::newConnection);
+}
+
+
+bool CControlServer::listen(const QString &name)
+{
+//  Start accepting clients
+//  Returns false if another instance is listening already or the socket could not be created
+    QLocalSocket probe;
+
+    server.setSocketOptions(QLocalServer::UserAccessOption);
+    if (server.listen(name)) {
+        logger.info() << "Control socket: " << server.fullServerName();
+        return true;
+    }
+
+    // A socket file left behind by a crashed instance blocks the name - remove it unless someone answers:
+    if (server.serverError() == QAbstractSocket::AddressInUseError) {
+        probe.connectToServer(name);
+        if (probe.waitForConnected(100)) {
+            logger.warning() << "listen(): Another instance owns the control socket " << name << " - not listening.";
+            return false;
+        }
+        QLocalServer::removeServer(name);
+        if (server.listen(name)) {
+            logger.info() << "Control socket: " << server.fullServerName();
+            return true;
+        }
+    }
+
+    qWarning("CControlServer::listen(): Could not open control socket!\n");
+    logger.warning() << "listen(): Could not open control socket " << name << ": " << server.errorString();
+    return false;
+}
+
+
+void CControlServer::close()
+{
+//  Stop accepting clients (connected clients are served until they disconnect)
+    server.close();
+}
+
+
+void CControlServer::newConnection()
+{
+    QLocalSocket *socket;
+
+    while (server.hasPendingConnections()) {
+        socket = server.nextPendingConnection();
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { readClient(socket); });
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+
+void CControlServer::readClient(QLocalSocket *socket)
+{
+//  Answer all complete command lines received so far with one write
+    QByteArray replies, line;
+    bool tooLong;
+    TRACE_SCOPE("CControlServer::readClient");
+
+    tooLong = false;
+    while (socket->canReadLine()) {
+        line = socket->readLine(CONTROL_MAX_LINE + 2);
+        if (!line.endsWith('\n')) {
+            tooLong = true;
+            break;
+        }
+        replies.append(execute(line));
+        replies.append('\n');
+    }
+
+    // A line that does not fit is not a command:
+    if (tooLong || socket->bytesAvailable() > CONTROL_MAX_LINE) {
+        logger.warning() << "readClient(): Command line too long - client disconnected.";
+        replies.append("ERR\tLine too long\n");
+        socket->write(replies);
+        socket->disconnectFromServer();
+        return;
+    }
+
+    if (!replies.isEmpty()) {
+        socket->write(replies);
+        socket->flush();
+    }
+}
+
+
+QByteArray CControlServer::execute(const QByteArray &line)
+{
+//  Run one command, return its reply (without the line feed)
+    QList<QByteArray> args = line.simplified().split(' ');
+    const QByteArray &command = args.at(0);
+    const CTaskStore &store = model.tasks();
+    QByteArray reply, title;
+    QDate   date;
+    quint32 seconds, total;
+    qint32  taskID;
+    int     row, time, day, i;
+    bool    ok, okTime, okDay;
+
+    if (command == "ping") {
+        return "OK";
+    }
+
+    if (command == "status") {
+        CTimeEngine::sSnapshot state = model.engineState();
+        reply = "OK\t" + QByteArray::number(model.activeTask());
+        reply += "\t" + QByteArray::number(state.taskID >= 0 ? state.runSeconds : 0);
+        reply += "\t" + QByteArray::number(store.totals().today.elapsedSeconds);
+        return reply;
+    }
+
+    if (command == "list") {
+        reply = "OK";
+        for (i=0; i<store.count(); i++) {
+            title = store.title(i).toUtf8();
+            title.replace('\t', ' ').replace('\n', ' ').replace('\r', ' ');
+            reply += "\t" + QByteArray::number(store.taskID(i)) + ":" + title;
+        }
+        return reply;
+    }
+
+    if (command == "start") {
+        taskID = args.value(1).toInt(&ok);
+        if (!ok) return "ERR\tUsage: start <taskID>";
+        if (!model.startTask(taskID)) return "ERR\tNo such task";
+        return "OK\t" + QByteArray::number(taskID);
+    }
+
+    if (command == "stop") {
+        model.stopTask();
+        return "OK";
+    }
+
+    if (command == "add") {
+        taskID = args.value(1).toInt(&ok);
+        time   = args.value(2).toInt(&okTime);
+        day    = 0;
+        okDay  = true;
+        if (args.count() > 3) day = args.at(3).toInt(&okDay);
+        if (day < -CONTROL_MAX_DAYS || day > CONTROL_MAX_DAYS) okDay = false;   // addTaskTime() takes a qint16
+        if (!ok || !okTime || !okDay) return "ERR\tUsage: add <taskID> <seconds> [day]";
+        if (!model.addTaskTime(taskID, day, time)) return "ERR\tNo such task";
+        row = store.row(taskID);
+        date = QDate::currentDate().addDays(day);
+        return "OK\t" + QByteArray::number(store.elapsedSeconds(row, date, date));
+    }
+
+    if (command == "day") {
+        day   = 0;
+        okDay = true;
+        if (args.count() > 1) day = args.at(1).toInt(&okDay);
+        if (day < -CONTROL_MAX_DAYS || day > CONTROL_MAX_DAYS) okDay = false;
+        if (!okDay) return "ERR\tUsage: day [day]";
+        date  = QDate::currentDate().addDays(day);
+        total = 0;
+        for (i=0; i<store.count(); i++) {
+            seconds = store.elapsedSeconds(i, date, date);
+            if (seconds == 0) continue;
+            reply += "\t" + QByteArray::number(store.taskID(i)) + ":" + QByteArray::number(seconds);
+            total += seconds;
+        }
+        return "OK\t" + date.toString(Qt::ISODate).toUtf8() + "\t" + QByteArray::number(total) + reply;
+    }
+
+    return "ERR\tUnknown command: " + command.left(32);
+}
@@ -0,0 +1,68 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CCONTROLSERVER_H
+#define CCONTROLSERVER_H
+
+#include <QObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QByteArray>
+#include "core/CLogger.h"
+
+// Name of the local socket (per user: only the user running Timekeeper may connect)
+#define CONTROL_SERVER_NAME  "Timekeeper-control"
+// Longest command line accepted - a client sending longer lines is disconnected
+#define CONTROL_MAX_LINE     4096
+// Range of the [day] argument (days relative to today, about 10 years either way)
+#define CONTROL_MAX_DAYS     3660
+
+class CTaskModel;
+
+
+// Control socket of the running instance, for scripts (IDE & git hooks, calendar scripts - see "Timekeeper --control")
+//
+// Line protocol (UTF-8, one command per line, fields separated by blanks); every command gets a reply line with
+// tab-separated fields, "OK ..." or "ERR <message>", in the order of the commands:
+//   ping                           OK
+//   status                         OK <running taskID or -1> <seconds since started> <seconds today, all tasks>
+//   list                           OK <taskID>:<title> ...
+//   start <taskID>                 OK <taskID>               (stops the task running so far)
+//   stop                           OK
+//   add <taskID> <seconds> [day]   OK <seconds of the task on that day>   (day: relative to today, default 0, at most CONTROL_MAX_DAYS away)
+//   day [day]                      OK <yyyy-MM-dd> <seconds, all tasks> <taskID>:<seconds> ...   (tasks with time only)
+// All complete lines received at once are answered with one write, so a batch of commands takes one round trip.
+// Queries are answered from the task store & the time engine's snapshot without touching the views; start & stop
+// update them through CTaskModel like a click would.
+class CControlServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    CControlServer(CTaskModel &model, CLogger &logger, QObject *parent = nullptr);
+
+    bool listen(const QString &name = CONTROL_SERVER_NAME);
+    void close();
+
+private:
+    QLocalServer server;
+    CTaskModel  &model;
+    CLogger     &logger;
+
+    void newConnection();
+    void readClient(QLocalSocket *socket);
+    QByteArray execute(const QByteArray &line);
+};
+
+#endif // CCONTROLSERVER_H
@@ -0,0 +1,158 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QEventLoop>
+#include <QFileInfo>
+#include "CHeadless.h"
+
+
+int CHeadless::run(int argc, char *argv[])
+{
+//  Parse the command line, then load and report on each file in turn
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    QString type, password, period, csv;
+    QDate   date, from, to;
+    int     i, status, ret;
+    char    line[256];
+
+    QCommandLineOption headlessOption("headless", "Run without GUI (required).");
+    QCommandLineOption reportOption("report", "Report to print: daily, monthly, yearly or range.", "type");
+    QCommandLineOption dateOption("date", "Day of a daily report, or any day of the month/year of a monthly/yearly report (yyyy-MM-dd, default: today).", "date");
+    QCommandLineOption fromOption("from", "First day of a range report (yyyy-MM-dd).", "date");
+    QCommandLineOption toOption("to", "Last day of a range report (yyyy-MM-dd, default: today).", "date");
+    QCommandLineOption csvOption("csv", "Export each file to CSV (written next to the save file, like the GUI does).");
+    QCommandLineOption stdinOption("password-stdin", "Read the password for encrypted files from the first line of stdin.");
+    QCommandLineOption envOption("password-env", "Read the password for encrypted files from this environment variable (default: TIMEKEEPER_PASSWORD).", "name", "TIMEKEEPER_PASSWORD");
+
+    parser.setApplicationDescription("Timekeeper headless mode - reports and CSV export without GUI");
+    parser.addHelpOption();
+    parser.addOptions({ headlessOption, reportOption, dateOption, fromOption, toOption, csvOption, stdinOption, envOption });
+    parser.addPositionalArgument("files", "Save files to process.", "<file>...");
+    parser.process(app);
+
+    // Period of the report:
+    type = parser.value(reportOption);
+    date = parser.isSet(dateOption) ? QDate::fromString(parser.value(dateOption), Qt::ISODate) : QDate::currentDate();
+    to   = parser.isSet(toOption)   ? QDate::fromString(parser.value(toOption), Qt::ISODate)   : QDate::currentDate();
+    from = QDate::fromString(parser.value(fromOption), Qt::ISODate);
+    if (type == "daily") {
+        from = to = date;
+        period = date.toString(Qt::ISODate);
+    }
+    else if (type == "monthly") {
+        from = QDate(date.year(), date.month(), 1);
+        to   = from.addMonths(1).addDays(-1);
+        period = date.toString("yyyy-MM");
+    }
+    else if (type == "yearly") {
+        from = QDate(date.year(), 1, 1);
+        to   = QDate(date.year(), 12, 31);
+        period = date.toString("yyyy");
+    }
+    else if (type == "range") {
+        period = from.toString(Qt::ISODate) + ".." + to.toString(Qt::ISODate);
+    }
+    else if (!type.isEmpty()) {
+        fprintf(stderr, "Unknown report type: %s\n", type.toUtf8().data());
+        return 1;
+    }
+    if (!type.isEmpty() && (!from.isValid() || !to.isValid() || from > to)) {
+        fprintf(stderr, "Invalid report period\n");
+        return 1;
+    }
+    if (parser.positionalArguments().isEmpty() || (type.isEmpty() && !parser.isSet(csvOption))) {
+        fprintf(stderr, "Nothing to do - give one or more files and --report and/or --csv (see --help)\n");
+        return 1;
+    }
+
+    // One password for all encrypted files:
+    password = qEnvironmentVariable(parser.value(envOption).toUtf8().data());
+    if (parser.isSet(stdinOption) && fgets(line, sizeof(line), stdin) != NULL) {
+        password = QString::fromUtf8(line).remove('\n').remove('\r');
+        clean(line, sizeof(line));
+    }
+
+    // Log file as in the GUI:
+    CLogger logger;
+    if (!logger.open("Timekeeper.log")) {
+        qWarning("Could not open log file!");
+    }
+    logger.info() << "Timekeeper v1.1 starting (headless).";
+
+    CTaskStore store(logger);
+    CSaveFile  saveFile(store, logger);
+
+    ret = 0;
+    if (!type.isEmpty()) printf("file\tperiod\ttask\tseconds\ttime\n");
+    for (i = 0; i < parser.positionalArguments().count(); i++) {
+        const QString file = parser.positionalArguments().at(i);
+        status = load(saveFile, file, password);
+        if (status != 0) {
+            fprintf(stderr, "%s: %s\n", file.toUtf8().data(),
+                    status == 1 ? "wrong password" : status == 4 ? "file damaged or modified" : "could not be read");
+            ret = 2;
+            continue;
+        }
+        if (!type.isEmpty()) report(store, file, period, from, to);
+        if (parser.isSet(csvOption)) {
+            csv = saveFile.csvWriter();
+            fprintf(stderr, "%s: exported to %s\n", file.toUtf8().data(), QFileInfo(file).dir().filePath(csv).toUtf8().data());
+        }
+    }
+    fflush(stdout);
+    logger.close();
+
+    return ret;
+}
+
+
+int CHeadless::load(CSaveFile &saveFile, const QString &file, const QString &password)
+{
+//  Load a save file and wait for it (encrypted files are loaded by a worker thread)
+//  Returns the status of CSaveFile::loaded()
+    QEventLoop loop;
+    int  status;
+    bool done;
+
+    status = 3;
+    done   = false;
+    QObject::connect(&saveFile, &CSaveFile::loaded, &loop, [&](int s) { status = s; done = true; loop.quit(); });
+    saveFile.load_data(password, QFileInfo(file).absoluteFilePath());
+    if (!done) loop.exec();
+
+    return status;
+}
+
+
+void CHeadless::report(const CTaskStore &store, const QString &file, const QString &period, const QDate &from, const QDate &to)
+{
+//  Print the time logged per task within from .. to
+    quint32 seconds, total;
+    int row;
+
+    total = 0;
+    for (row = 0; row < store.count(); row++) {
+        seconds = store.elapsedSeconds(row, from, to);
+        total  += seconds;
+        printf("%s\t%s\t%s\t%u\t%02u:%02u:%02u\n", file.toUtf8().data(), period.toUtf8().data(),
+               store.title(row).toUtf8().data(),
+               seconds, seconds / 3600, (seconds / 60) % 60, seconds % 60);
+    }
+    printf("%s\t%s\t(total)\t%u\t%02u:%02u:%02u\n", file.toUtf8().data(), period.toUtf8().data(),
+           total, total / 3600, (total / 60) % 60, total % 60);
+}
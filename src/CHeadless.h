@@ -0,0 +1,39 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CHEADLESS_H
+#define CHEADLESS_H
+
+#include <QString>
+#include <QDate>
+#include "core/CTaskStore.h"
+#include "core/CSaveFile.h"
+
+// Headless mode ("Timekeeper --headless ..."): reports & CSV export for one or more save files, without QML engine,
+// tray icon or screen - the core (CTaskStore, CSaveFile) runs on a QCoreApplication. Meant for scripts, see "Timekeeper --headless --help".
+//
+// Reports are printed to stdout as tab-separated lines: file, period, task, seconds, hh:mm:ss (one line per task and
+// a "(total)" line per file). Errors go to stderr; the exit code is 0 if all files were processed, 1 for bad arguments
+// and 2 if a file could not be loaded (the other files are processed anyway).
+class CHeadless
+{
+public:
+    static int run(int argc, char *argv[]);
+
+private:
+    static int  load(CSaveFile &saveFile, const QString &file, const QString &password);
+    static void report(const CTaskStore &store, const QString &file, const QString &period, const QDate &from, const QDate &to);
+};
+
+#endif // CHEADLESS_H
@@ -0,0 +1,259 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <string.h>
+#include <QTemporaryDir>
+#include <QEventLoop>
+#include <QRandomGenerator>
+#include <QFileInfo>
+#include "CModelBenchmark.h"
+#include "core/CCsvImport.h"
+#include "core/CAggregate.h"
+
+
+int CModelBenchmark::run(const QStringList &args)
+{
+//  Run the benchmark - args: [tasks] [years] [density] [password] (after "--benchmark-model")
+//  Returns 0 on success, 1 if a file could not be written or loaded
+    sParams params;
+    QTemporaryDir dir;
+    QString file;
+    QElapsedTimer clock;
+    int status, i, n;
+    quint64 hot, cold, timelogs;
+    bool done;
+
+    status = -1;
+
+    params.tasks    = args.value(0, "50").toInt();
+    params.years    = args.value(1, "5").toInt();
+    params.density  = args.value(2, "0.5").toDouble();
+    params.password = args.value(3, "");
+    if (params.tasks < 1 || params.years < 0 || params.density < 0.0 || params.density > 1.0) {
+        fprintf(stderr, "Usage: Timekeeper --benchmark-model [tasks] [years] [density 0..1] [password]\n");
+        return 1;
+    }
+
+    // The core writes its log, ini & backup files to the current directory - keep them out of the user's:
+    if (!dir.isValid()) return 1;
+    QDir::setCurrent(dir.path());
+    file = dir.filePath("benchmark.tkp");
+
+    clock.start();
+    if (!generateFile(file, params)) {
+        fprintf(stderr, "Could not write %s\n", file.toUtf8().data());
+        return 1;
+    }
+    printf("# tasks=%d years=%d density=%.2f encrypted=%d file_bytes=%lld generate_ms=%lld\n",
+           params.tasks, params.years, params.density, params.password.isEmpty() ? 0 : 1,
+           (long long) QFileInfo(file).size(), (long long) clock.elapsed());
+    printf("name\tcalls\tms/call\n");
+
+    CLogger logger;
+    logger.open("Timekeeper.log");
+    CTaskStore store(logger);
+    CSaveFile saveFile(store, logger);
+
+    // Encrypted files are loaded by a worker thread - wait for loaded():
+    auto load = [&]() {
+        QEventLoop loop;
+        done = false;
+        QObject::connect(&saveFile, &CSaveFile::loaded, &loop, [&](int s) { status = s; done = true; loop.quit(); });
+        saveFile.load_data(params.password, file);
+        if (!done) loop.exec();
+    };
+
+    measure("load_data (v100)", 3, 1000, load);
+    if (status != 0 || store.count() != params.tasks) {
+        fprintf(stderr, "Could not load %s (status %d)\n", file.toUtf8().data(), status);
+        return 1;
+    }
+
+    // Memory of the tasks as loaded (estimate, see CTaskStore::memoryUsage()):
+    store.memoryUsage(hot, cold, timelogs);
+    printf("# bytes_per_task hot=%.1f cold=%.1f timelog=%.1f\n",
+           double(hot) / store.count(), double(cold) / store.count(), double(timelogs) / store.count());
+
+    // Encrypted: the first save converts the file to the current version, later ones only rewrite changed pages
+    measure("save_data (first)", 1, 0, [&]() { saveFile.save_data(file); });
+    measure("save_data (unchanged)", 3, 1000, [&]() { saveFile.save_data(file); });
+    measure("save_data (one task changed)", 3, 1000, [&]() { store.addTime(0, store.today(), 60); saveFile.save_data(file); });
+    if (!params.password.isEmpty()) {
+        measure("load_data (current version)", 3, 1000, load);
+        if (status != 0) {
+            fprintf(stderr, "Could not load %s after saving (status %d)\n", file.toUtf8().data(), status);
+            return 1;
+        }
+    }
+
+    measure("tick", 10, 500, [&]() { store.tick(store.taskID(0)); });
+    measure("refresh", 10, 500, [&]() { store.refresh(); });
+    measure("updateTotals", 10, 500, [&]() { store.updateTotals(); });
+    measure("updateDaily", 10, 500, [&]() { store.updateDaily(QDate::currentDate()); });
+    measure("updateMonthly", 10, 500, [&]() { store.updateMonthly(QDate::currentDate().month(), QDate::currentDate().year()); });
+    measure("updateYearly", 10, 500, [&]() { store.updateYearly(QDate::currentDate().year()); });
+
+    // The kernel of the report sums on its own (see CAggregate) - on the tasks loaded & on 10k tasks with time every other day:
+    CAggregate loaded, large;
+    QVector<quint32> perRow;
+    QDate first(QDate::currentDate().year(), 1, 1);
+    measure("fillAggregate", 3, 500, [&]() { store.fillAggregate(loaded, first.year()); });
+    large.reset(first.year(), 10000);
+    for (i = 0; i < large.rows(); i++) {
+        for (n = 0; n < first.daysInYear(); n += 2) large.set(i, first.addDays(n), QRandomGenerator::global()->bounded(36000));
+    }
+    for (i = CAggregate::Scalar; i <= CAggregate::bestKernel(); i++) {
+        loaded.setKernel((CAggregate::eKernel) i);
+        large.setKernel((CAggregate::eKernel) i);
+        measure(QString("aggregate year, %1 tasks (%2)").arg(loaded.rows()).arg(CAggregate::kernelName(loaded.kernel())), 10, 500,
+                [&]() { loaded.sum(0, first.daysInYear() - 1, perRow, n); });
+        measure(QString("aggregate year, 10000 tasks (%1)").arg(CAggregate::kernelName(large.kernel())), 10, 500,
+                [&]() { large.sum(0, first.daysInYear() - 1, perRow, n); });
+        measure(QString("aggregate month, 10000 tasks (%1)").arg(CAggregate::kernelName(large.kernel())), 10, 500,
+                [&]() { large.sum(first.daysInMonth(), first.daysInMonth() + 27, perRow, n); });
+    }
+
+    // Alternating the order makes every call reverse the list:
+    for (i = 0; i < 5; i++) {
+        n = 0;
+        measure(QString("sort(%1)").arg(i), 2, 500, [&]() { store.sort(i, (n++ & 1) ? Qt::DescendingOrder : Qt::AscendingOrder); });
+    }
+
+    measure("csvWriter", 1, 500, [&]() { saveFile.csvWriter(); });
+
+    // Reads the last export back - the times of the same days are replaced, so every call does the same work:
+    QString csv = saveFile.csvWriter();
+    measure("importCsv (wide)", 1, 500, [&]() { CCsvImport import; if (import.readFile(csv)) import.apply(store); });
+
+    // Moves all time of the first task onto up to 5 others - only the first call has anything to do:
+    for (i = 1; i < qMin(6, store.count()); i++) store.setAllocate(i, 1);
+    measure("reallocateAll", 1, 0, [&]() { store.reallocateAll(0, true); });
+
+    saveFile.close();
+    logger.close();
+
+    return 0;
+}
+
+
+bool CModelBenchmark::generateFile(const QString &file, const sParams &params)
+{
+//  Write a version 100 save file with synthetic tasks (the same data for the same parameters)
+    QRandomGenerator random(0x051076A0);
+    CLogger logger;
+    CTaskStore store(logger);
+    CSaveFile saveFile(store, logger);
+    QList<CTaskStore::Task> tasks;
+    CTaskStore::Task task;
+    QDate date, first, last;
+    quint32 seconds, total;
+    int i;
+
+    last  = QDate::currentDate();
+    first = last.addYears(-params.years);
+
+    for (i = 0; i < params.tasks; i++) {
+        task = CTaskStore::Task();
+        task.title       = QString("Task %1").arg(i + 1);
+        task.description = QString("Synthetic task no. %1").arg(i + 1);
+        task.taskID      = i + 1;
+        total = 0;
+        for (date = first; date <= last; date = date.addDays(1)) {
+            if (random.generateDouble() >= params.density) continue;
+            seconds = random.bounded(60, 4 * 3600);
+            task.timelog.insert(date, { (quint16) (seconds / 3600), (quint16) ((seconds / 60) % 60), (quint16) (seconds % 60), seconds });
+            total += seconds;
+        }
+        task.timeTotal = { (quint16) (total / 3600), (quint16) ((total / 60) % 60), (quint16) (total % 60), total };
+        tasks.append(task);
+    }
+    // Computes today's, this month's & this year's times as the GUI would have saved them:
+    store.setTasks(tasks);
+
+    saveFile.activeFile.SaveFileNameFull = file;
+    if (params.password.isEmpty()) return saveFile.writefile() == 0;
+
+    return writeEncrypted(saveFile, file, params.password);
+}
+
+
+bool CModelBenchmark::writeEncrypted(CSaveFile &saveFile, const QString &file, const QString &password)
+{
+//  Write an encrypted version 100 file (PBKDF2-HMAC-SHA1, AES256-CBC) as Timekeeper 1.0 did - saving only writes the current version
+//  The plaintext is one leading block, the task records and 1 to 16 Bytes of padding
+    QFile   out;
+    QByteArray header, plain;
+    SecureArena arena;
+    CBC<AES256> cbc;
+    SHA256  hash;
+    uint8_t key[32], iv[16], salt[16], passwordHash[32];
+    quint32 random_number;
+    int     i, len;
+
+    for (i=0; i<16; i+=4) {
+        random_number = QRandomGenerator::global()->generate();
+        memcpy(&salt[i], &random_number, 4);
+        random_number = QRandomGenerator::global()->generate();
+        memcpy(&iv[i], &random_number, 4);
+    }
+    if (CSaveFile::deriveKey(password, salt, 100, key) != 0) return false;
+
+    len = qMin(password.length(), 32);
+    hash.update(password.toUtf8().data(), len);
+    hash.finalize(passwordHash, 32);
+
+    QDataStream stream(&header, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << (quint32) 0x051076B0;
+    stream << (quint16) 100;
+    for (i = 0; i < 16; i++) stream << (quint8) salt[i];
+    for (i = 0; i < 32; i++) stream << (quint8) passwordHash[i];
+
+    plain.fill(0, 16);
+    for (i = 0; i < saveFile.store.count(); i++) {
+        plain.append(saveFile.serializeTask(i, arena));
+    }
+    plain.append(QByteArray(16 - plain.size() % 16, 0));
+
+    cbc.setKey(key, 32);
+    cbc.setIV(iv, 16);
+    cbc.encrypt((uint8_t*) plain.data(), (const uint8_t*) plain.constData(), plain.size());
+    clean(key, sizeof(key));
+
+    out.setFileName(file);
+    if (!out.open(QIODevice::WriteOnly)) return false;
+    if (out.write(header) != header.size() || out.write(plain) != plain.size()) return false;
+    out.close();
+
+    return true;
+}
+
+
+void CModelBenchmark::measure(const QString &name, int minCalls, qint64 minTime, std::function<void()> op)
+{
+//  Call op at least minCalls times and for at least minTime ms, print the mean time per call
+    QElapsedTimer clock;
+    int calls;
+
+    calls = 0;
+    clock.start();
+    do {
+        op();
+        calls++;
+    } while (calls < minCalls || clock.elapsed() < minTime);
+
+    printf("%s\t%d\t%.4f\n", name.toUtf8().data(), calls, clock.nsecsElapsed() / 1e6 / calls);
+    fflush(stdout);
+}
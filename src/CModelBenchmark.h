@@ -0,0 +1,50 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef CMODELBENCHMARK_H
+#define CMODELBENCHMARK_H
+
+#include <QString>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <functional>
+#include "core/CLogger.h"
+#include "core/CTaskStore.h"
+#include "core/CSaveFile.h"
+
+// Headless benchmark of the core (task store & save file) on synthetic save files ("Timekeeper --benchmark-model", see main.cpp).
+// Writes a version 100 file (unencrypted or encrypted) with the given no. of tasks, years of history and density
+// (share of days with time logged on a task), then times loading, saving and the store functions driven by the GUI.
+// Results are printed as tab-separated lines (name, calls, ms per call), so they can be compared between versions.
+class CModelBenchmark
+{
+public:
+    struct sParams {
+        int     tasks;       // No. of tasks
+        int     years;       // Years of timelog history up to today
+        double  density;     // Share of days with time logged per task (0 .. 1)
+        QString password;    // Empty: unencrypted file
+    };
+
+    static int run(const QStringList &args);
+
+    static bool generateFile(const QString &file, const sParams &params);
+
+
+private:
+    static void measure(const QString &name, int minCalls, qint64 minTime, std::function<void()> op);
+    static bool writeEncrypted(CSaveFile &saveFile, const QString &file, const QString &password);
+};
+
+#endif // CMODELBENCHMARK_H
@@ -15,27 +15,25 @@ If not, see <https://www.gnu.org/licenses/>.
 #ifndef CTASKMODEL_H
 #define CTASKMODEL_H
 
-#include <math.h>
 #include <QAbstractListModel>
 #include <QTime>
 #include <QTimer>
 #include <QFile>
-#include <QDataStream>
 #include <QTextStream>
-#include <QBuffer>
 #include <QScreen>
-#include <QInputDialog>
-#include <QRandomGenerator>
 #include <QUrl>
 #include <QDir>
 #include <QDesktopServices>
-#include "crypto/Crypto.h"
-#include "crypto/CBC.h"
-#include "crypto/AES.h"
-#include "crypto/SHA256.h"
-#include "crypto/pbkdf2.h"
+#include "core/CLogger.h"
+#include "core/CTaskStore.h"
+#include "core/CSaveFile.h"
+#include "core/CTimeEngine.h"
+#include "CControlServer.h"
 
 
+// Presents the tasks of a CTaskStore to QML and keeps the GUI state (settings, window geometry, password dialog).
+// Counting time, aggregation and file handling are done by the core (CTaskStore, CSaveFile) - this class forwards the calls
+// from QML and tells the views which rows and roles changed.
 class CTaskModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -79,12 +77,7 @@ public:
     Q_ENUM(TaskRole)
 
     // Public types
-    struct sTime {
-        quint16 Hours;
-        quint16 Minutes;
-        quint16 Seconds;
-        quint32 elapsedSeconds;
-    };
+    typedef CTaskStore::sTime sTime;
 
     CTaskModel(QObject *parent = nullptr);
     ~CTaskModel();
@@ -126,22 +119,25 @@ public:
     Q_PROPERTY(quint16 windowHeight  MEMBER m_windowHeight     NOTIFY windowPosChanged)
     Q_PROPERTY(quint8  PWneeded      MEMBER m_PWneeded         NOTIFY PasswordNeeded)
     Q_PROPERTY(quint8  PWwrong       MEMBER m_PWwrong          NOTIFY WrongPassword)
+    Q_PROPERTY(quint8  PWbusy        MEMBER m_PWbusy           NOTIFY PasswordProgress)
+    Q_PROPERTY(quint8  PWprogress    MEMBER m_PWprogress       NOTIFY PasswordProgress)
     Q_PROPERTY(QString SaveFile      MEMBER m_SaveFileName     NOTIFY settingChanged)
     Q_PROPERTY(QString SaveFileFull  MEMBER m_SaveFileNameFull NOTIFY settingChanged)
     Q_PROPERTY(quint8  FileEncrypted MEMBER m_FileEncrypted    NOTIFY settingChanged)
     Q_PROPERTY(QString LogFileFull   MEMBER m_LogFileNameFull  NOTIFY settingChanged)
+    Q_PROPERTY(QString undoText      MEMBER m_undoText         NOTIFY undoChanged)   // Label of the edit undo() reverts ("" if none)
+    Q_PROPERTY(QString redoText      MEMBER m_redoText         NOTIFY undoChanged)
 
 
     Q_INVOKABLE QVariantMap get(int row) const;
     Q_INVOKABLE void checkFileType(QString File);
     Q_INVOKABLE void load_data(QString Password, QString File);
+    Q_INVOKABLE void cancelLoad();
     Q_INVOKABLE int  save_data(QString File);
     Q_INVOKABLE void set_password(QString PW);
     Q_INVOKABLE void removeEncryption();
     Q_INVOKABLE int  append(const QString &title, const QString &description);
     Q_INVOKABLE void set(int row, const QString &title, const QString &description);
-    Q_INVOKABLE void updateEntry(int row, const sTime timeTotal, const sTime timeToday, const QString timeTodayString, const sTime timeThisMonth, const QString timeThisMonthString, const sTime timeThisYear, const QString timeThisYearString);
-    Q_INVOKABLE void updateEntry2(int row, const QDate date, const sTime timeToDate);
     Q_INVOKABLE void sort(int column, Qt::SortOrder order=Qt::AscendingOrder);
     Q_INVOKABLE int  row(qint32 taskID);
     Q_INVOKABLE void startTimer(int row);
@@ -150,6 +146,7 @@ public:
     Q_INVOKABLE void resetAllocate();
     Q_INVOKABLE void reallocate(int row, qint16 day, quint16 weighted);
     Q_INVOKABLE void reallocateAll(int row, qint16 day, quint16 weighted);
+    Q_INVOKABLE void reallocateRange(int row, qint16 fromDay, qint16 toDay, qint16 day, quint16 weighted);
     Q_INVOKABLE void add_time(int row, qint16 day, int hours, int minutes, int seconds);
     Q_INVOKABLE void updateTotals();
     Q_INVOKABLE void updateYearlyList(quint16 year);
@@ -162,22 +159,31 @@ public:
     Q_INVOKABLE void resetAll();
     Q_INVOKABLE void savePosition(int x, int y, int width, int height);
     Q_INVOKABLE QString csvWriter();
+    Q_INVOKABLE QVariantMap importCsv(QString File);
     Q_INVOKABLE void openHelp();
     Q_INVOKABLE void restoreBackup();    // Unused
+    Q_INVOKABLE int  applyEdits(const QVariantList &edits);
+    Q_INVOKABLE bool undo();
+    Q_INVOKABLE bool redo();
 
     void checkEntries(int row);   // Debug: Print all timelog entries for one task
+    void beginBatch();
+    void commitBatch();
     void Update();
     void UpdateAll();
     bool readIniFile();
-    bool readfile(QString filename);
-    bool readfileEncrypted(QString filename);
-    int  writefile();
-    int  writefileEncrypted();
     void writeIniFile();
-    void backupfile();
     void checkDayChange();
     void updatePosition();
 
+    // Control socket (see CControlServer) - tasks by ID, main.qml follows through activeTaskChanged():
+    bool startTask(qint32 taskID);
+    void stopTask();
+    bool addTaskTime(qint32 taskID, qint16 day, int seconds);
+    const CTaskStore &tasks() const { return store; }
+    qint32 activeTask() const { return activeID; }
+    CTimeEngine::sSnapshot engineState() const { return engine.snapshot(); }
+
 
 signals:
     void TimeChanged();
@@ -185,38 +191,20 @@ signals:
     void settingChanged();
     void PasswordNeeded();
     void WrongPassword();
+    void PasswordProgress();
+    void loadFinished(int status);   // 0: OK, 1: Wrong password, 2: Cancelled, 3: File could not be read, 4: File damaged or modified
     void closing();
+    void undoChanged();
+    void activeTaskChanged(int row, int taskID);   // Started or stopped through the control socket (row -1: none running)
 
 
 private:
-    // The basic Task structure:
-    struct Task {
-        QString title;
-        QString description;
-        quint32 taskID;
-        quint8  taskActive;           // 1 if this task is currently counting time
-        quint8  allocateTime;         // 1 if this task is a target for reallocation
-        sTime   timeTotal;            // Total time logged on task
-        sTime   timeToday;            // Time logged on task today
-        QString timeTodayString;      // String to display time logged on task today
-        sTime   timeThisMonth;        // Time logged on task this month
-        QString timeThisMonthString;  // String to display time logged on task this month
-        sTime   timeThisYear;         // Time logged on task this year
-        QString timeThisYearString;   // String to display time logged on task this year
-        sTime   timeDaily;            // Time logged on task per day (for report window; only ever holds the last day queried by the HMI)
-        QString timeDailyString;      // String to display time logged on task per day
-        sTime   timeMonthly;          // Time logged on task per month (for report window; only ever holds the last month queried by the HMI)
-        QString timeMonthlyString;    // String to display time logged on task per month
-        sTime   timeYearly;           // Time logged on task per year (for report window; only ever holds the last year queried by the HMI)
-        QString timeYearlyString;     // String to display time logged on task per year
-        QMap<QDate, sTime> timelog;   // Map between date and time logged per day
-    };
-    // The global list of Tasks:
-    QList<Task> m_tasks;
+    CLogger    logger;      // Logging output (asynchronous) - used by the core, so it is constructed first
+    CTaskStore store;       // The tasks
+    CSaveFile  saveFile;    // Loading & saving the tasks
+    CTimeEngine engine;     // Counts the time of the active task on its own thread
+    CControlServer control; // Local socket for scripts
 
-    sTime   totalTimeToday;
-    sTime   totalTimeThisMonth;
-    sTime   totalTimeThisYear;
     QString m_totalTimeDailyString;      // For report window
     QString m_totalTimeMonthlyString;    // For report window
     QString m_totalTimeYearlyString;     // For report window
@@ -226,14 +214,11 @@ private:
     quint16 m_daysWorkedMonthly;         // For report window
     quint16 m_daysWorkedYearly;          // For report window
 
-    QDate   today;
-    quint8  thisMonth, thisMonthSaved;
-    quint16 thisYear, thisYearSaved;
     quint16 m_TotalHoursToday, m_TotalMinutesToday, m_TotalSecondsToday;
     quint16 m_TotalHoursThisMonth, m_TotalMinutesThisMonth, m_TotalSecondsThisMonth;
     quint16 m_TotalHoursThisYear, m_TotalMinutesThisYear, m_TotalSecondsThisYear;
     QString m_TotalTimeToday, m_TotalTimeThisMonth, m_TotalTimeThisYear;
-    QTimer  timer;            // The main timer for tasks
+    QTimer  timer;            // Shows the time counted by the engine while a task is active (display rate only)
     QTimer  dayChangeCheck;   // Timer to check if day has changed
     // Settings
     qint16  m_settingLastSelectedDate;
@@ -247,46 +232,42 @@ private:
     qint16  m_windowPosXSave, m_windowPosYSave;
     quint16 m_windowWidthSave, m_windowHeightSave;
     quint8  m_PWneeded, m_PWwrong, m_FileEncrypted;
+    quint8  m_PWbusy, m_PWprogress;
     QScreen *Screen;
     QRect   ScreenSize;
 
-    int     activeRow;  // Holds the currently active row in the QList.
     qint32  activeID;   // Holds the currently active (counting) taskID. -1 if no task is counting.
 
     // File management
-    quint32 magic_no;            // File type magic number (0x051076A0: Unencrypted, 0x051076B0: Encrypted)
-    quint16 version_no;          // Save file version number (currently: 100)
     QString m_SaveFileName;      // Holds name of the currently used save file
     QString m_SaveFileNameFull;  // Holds full path to the currently used save file
     QString m_LogFileNameFull;   // Holds full path to the currently used log file
     quint8  m_defaultFile;       // Flags whether there is a default file specified in the ini file (to inform QML)
-    struct sFile {
-        QString SaveFileName;          // Holds name of the currently used save file
-        QString SaveFileNameFull;      // Holds full path to the currently used save file
-        quint32 magic_no;              // File type magic number (0x051076A0: Unencrypted, 0x051076B0: Encrypted)
-        uint8_t encrypted;             // File is encrypted [1] or not [0]
-        uint8_t salt[16];              // The salt used with this password
-        QString Password;              // The password to use for this file
-        uint8_t PasswordHashRead[32];  // The hashed password read from this file
-    };
-    sFile  activeFile;      // The file currently loaded
-    sFile  newFile;         // Temporary file object for loading operations
-    QFile  logFile;         // File for logging output
-    QTextStream logOut;
 
-    // Crypto
-    // Encryption works as follows:
-    // All time data is encrypted in Cipher Block Chaining mode using a random IV.
-    // 16 Bytes of null data are prepended when writing the file and discarded on read so we don't need to remember the IV.
-    // The encryption key is derived from the user password and a random salt using a PBKDF2 function.
-    // The salt and the hashed password are stored within the encrypted file (the salt to generate the encryption key for decryption,
-    // the hashed password to check whether the entered password is correct).
-    CBC<AES256>  cbc;      // Cipher Block Chaining using AES256
-    SHA256  sha256;        // Hashing algorithm
-    uint8_t key[32];       // The key used for encryption (this is not the password!)
-    uint8_t salt[16];      // The salt used with the password to generate the key
-    uint8_t iv[16];        // The initialization vector for CBC
-    uint8_t PasswordHash[32];   // The hashed password (for saving in the encrypted file & comparing entered password with saved one)
+    quint64 queued;     // Seconds queued by the engine as of the last takeCredits() - more means credits are waiting
+
+    // Batch of edits (beginBatch() .. commitBatch()): what the views need to be told once at the end
+    int     batchDepth;
+    int     batchFirst, batchLast;   // Rows changed (none if batchFirst > batchLast)
+    QVector<int> batchRoles;
+    bool    batchTotals;             // updateTotals() needed
+    bool    batchDaily;              // updateDailyList(batchDay) needed
+    qint16  batchDay;
+
+    // Undo & redo (see CTaskStore::beginUndoStep())
+    QString m_undoText, m_redoText;
+
+    void rowsChanged(int first, int last, const QVector<int> &roles);
+    void rowsEdited(int first, int last, const QVector<int> &roles);
+    void totalsEdited();
+    void dailyEdited(qint16 day);
+    void beginEdit(const QString &label);
+    void commitEdit();
+    void updateUndo();
+    bool undoRedo(bool redo);
+    void tasksAboutToBeReplaced();
+    void fileLoaded(int status);
+    bool takeCredits(bool flush);
 
 };
 
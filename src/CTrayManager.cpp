@@ -14,6 +14,7 @@ If not, see <https://www.gnu.org/licenses/>.
 */
 #include <QtWidgets/QApplication>
 #include "CTrayManager.h"
+#include "core/CTrace.h"
 
 CTrayManager::CTrayManager(QObject *parent) : QObject(parent)
 {
@@ -41,6 +42,13 @@ CTrayManager::CTrayManager(QObject *parent) : QObject(parent)
     hideRestoreAction = new QAction("&Hide/Restore", trayIconMenu);
     hideRestoreAction->setStatusTip("Hide/Restore Timekeeper window");
     trayIconMenu->addAction(hideRestoreAction);
+    // Only when tracing (see CTrace):
+    traceAction = nullptr;
+    if (CTrace::enabled()) {
+        traceAction = new QAction("Write &trace", trayIconMenu);
+        traceAction->setStatusTip("Write the recorded trace spans to the trace file");
+        trayIconMenu->addAction(traceAction);
+    }
     trayIconMenu->addSeparator();
     trayIconMenu->addAction(quitAction);
 
@@ -101,6 +109,9 @@ void CTrayManager::setup(QApplication *app)
     QObject::connect(hideRestoreAction, &QAction::triggered, this, &CTrayManager::onHideRestore);
     // When quitting, restore all previous windows and send close event to main window:
     QObject::connect(quitAction, &QAction::triggered, this, &CTrayManager::onQuit);
+    if (traceAction != nullptr) {
+        QObject::connect(traceAction, &QAction::triggered, this, &CTrayManager::onWriteTrace);
+    }
     // Minimize to tray:
     if (m_settingMinimizeToTray > 0) {
         QObject::connect(appWindow, &QWindow::windowStateChanged, this, &CTrayManager::onMinimize);
@@ -115,6 +126,7 @@ void CTrayManager::setup(QApplication *app)
 void CTrayManager::updateSettings()
 {
 //  Update any settings that were changed in the QML part
+    TRACE_SCOPE("CTrayManager::updateSettings");
 
     // Minimize to tray:
     if (m_settingMinimizeToTray > 0) {
@@ -131,6 +143,7 @@ void CTrayManager::updateIcon(quint8 type)
 {
 //  Update the icon
 //  type:  0=Regular icon, 1=Alert icon
+    TRACE_SCOPE("CTrayManager::updateIcon");
 
     if (type==1) {
         trayIcon->setIcon(iconAlert);
@@ -151,6 +164,7 @@ void CTrayManager::onHide()
 {
 //  Hide all visible windows
     int i;
+    TRACE_SCOPE("CTrayManager::onHide");
 
     if (!hidden) {
         // Memorize which windows were visible at time of hiding:
@@ -171,6 +185,7 @@ void CTrayManager::onRestore()
 {
 //  Restore all previously visible windows
     int i;
+    TRACE_SCOPE("CTrayManager::onRestore");
 
     if (hidden) {
         // Restore only those windows which were visible at time of hiding:
@@ -189,6 +204,7 @@ void CTrayManager::onHideRestore()
 {
 //  Hide all visible windows / Restore all previously visible windows
     int i;
+    TRACE_SCOPE("CTrayManager::onHideRestore");
 
     if (!hidden) {
         // Memorize which windows were visible at time of hiding:
@@ -218,6 +234,7 @@ void CTrayManager::onMinimize(Qt::WindowState windowState)
 {
 //  Minimize to tray (only connected to signal if appropriate setting is set)
     int i;
+    TRACE_SCOPE("CTrayManager::onMinimize");
 
     if (windowState==Qt::WindowMinimized) {
         if (!hidden) {
@@ -240,6 +257,7 @@ void CTrayManager::onQuit()
 {
 //  Restore the main application windows if it was hidden, then send it a close event
     int i;
+    TRACE_SCOPE("CTrayManager::onQuit");
 
     if (hidden) {
         // Restore other windows:
@@ -261,6 +279,16 @@ void CTrayManager::onQuit()
 }
 
 
+void CTrayManager::onWriteTrace()
+{
+//  Write the trace recorded so far (tracing keeps running)
+
+    if (CTrace::dump()) {
+        trayIcon->showMessage("Timekeeper", "Trace written.", icon, 3000);
+    }
+}
+
+
 void CTrayManager::cleanup()
 {
 // Make sure the system tray is removed (mainly required for Windows)
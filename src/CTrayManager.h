@@ -52,6 +52,7 @@ public slots:
     void onHideRestore();
     void onMinimize(Qt::WindowState windowState);
     void onQuit();
+    void onWriteTrace();
     void cleanup();
 
 
@@ -67,6 +68,7 @@ private:
     QAction *hideAction;
     QAction *restoreAction;
     QAction *hideRestoreAction;
+    QAction *traceAction;           // Only created when tracing is enabled
     QWindowList wndList;            // List containing all the top-level windows of the application
     QWindow *appWindow;
 
@@ -0,0 +1,49 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+import QtQuick 2.9
+import QtQuick.Dialogs 1.3
+
+FileDialog {
+    id: importCsv
+
+    folder: "."
+    selectExisting: true
+    selectMultiple: false
+    nameFilters: ["CSV files (*.csv)", "All files (*)"]
+
+    title: "Please select CSV file to import"
+    onAccepted: {
+        var s
+        var path = importCsv.fileUrl.toString()
+        if (path.startsWith("file:///")) {
+            var k = path.charAt(9) === ':' ? 8 : 7
+            s = path.substring(k)
+        } else {
+            s = path
+        }
+
+        // Adds the times to the tasks of the same title (missing tasks are created) - nothing is changed if the file has errors:
+        var result = listView.model.importCsv(s);
+        optionsMenu.importOk      = result.ok;
+        optionsMenu.importMessage = result.message;
+        notificationPopup.type = 4;
+        notificationPopup.open();
+    }
+
+    onRejected: {
+
+    }
+
+}
@@ -23,7 +23,7 @@ Dialog {
     x: parent.width / 2 - width / 2
     y: parent.height / 2 - height / 2
 
-    property int type: 1    // 1: Removing password from unencrypted file, 2: CSV file written, 3: Error while saving
+    property int type: 1    // 1: Removing password from unencrypted file, 2: CSV file written, 3: Error while saving, 4: CSV file imported
 
     bottomPadding: -1
     topPadding: -1
@@ -58,6 +58,9 @@ Dialog {
                 case 3:
                     "Oops"
                     break;
+                case 4:
+                    optionsMenu.importOk ? "Success" : "Oops"
+                    break;
                 }
             }
         }
@@ -95,6 +98,9 @@ Dialog {
                 case 3:
                     "Error saving file!"
                     break;
+                case 4:
+                    optionsMenu.importOk ? optionsMenu.importMessage : "Error importing CSV file!\n" + optionsMenu.importMessage
+                    break;
                 }
             }
         }
@@ -19,6 +19,8 @@ Menu {
     id: options
 
     property string csvname: ""
+    property bool   importOk: false
+    property string importMessage: ""
 
     Action {
         text: "Load file..."
@@ -70,6 +72,13 @@ Menu {
         }
      }
 
+     Action {
+        text: "Import from CSV..."
+        onTriggered: {
+            importCsv.open();
+        }
+     }
+
      Action {
         text: "Close file..."
         onTriggered: {
@@ -127,6 +136,22 @@ Menu {
        }
     }
 
+    Action {
+        text: listView.model.undoText.length > 0 ? "Undo: " + listView.model.undoText : "Undo"
+        enabled: listView.model.undoText.length > 0
+        onTriggered: {
+            listView.model.undo();
+        }
+    }
+
+    Action {
+        text: listView.model.redoText.length > 0 ? "Redo: " + listView.model.redoText : "Redo"
+        enabled: listView.model.redoText.length > 0
+        onTriggered: {
+            listView.model.redo();
+        }
+    }
+
     Action {
         text: "Reset all times..."
         onTriggered: {
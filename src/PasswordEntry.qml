@@ -22,9 +22,10 @@ Dialog {
     property string filename: ""
     property int    mode: 0         // 0: Query new password and update in model, 1: Query password and load file
     property int    visi: 0         // Visiblity of password
+    property int    busy: listView.model.PWbusy   // 1 while the file is being unlocked (mode 1)
 
     width: 320
-    height: 180
+    height: 195
     x: parent.width / 2 - width / 2
     y: parent.height / 2 - height / 2
 
@@ -35,7 +36,7 @@ Dialog {
 
     focus: true
     modal: true
-    closePolicy: Dialog.CloseOnEscape
+    closePolicy: busy ? Dialog.NoAutoClose : Dialog.CloseOnEscape
 
     onOpened: {
         pwText.clear();
@@ -47,6 +48,22 @@ Dialog {
         pwText.clear();
     }
 
+    // Loading an encrypted file runs in the background - close when it is done, stay open for another try if it was cancelled:
+    Connections {
+        target: listView.model
+        onLoadFinished: {
+            if (pwEntry.mode===1 && pwEntry.opened) {
+                if (status===2) {
+                    pwText.clear();
+                    pwText.focus = true;
+                }
+                else {
+                    pwEntry.close();
+                }
+            }
+        }
+    }
+
     header: Rectangle {
         height: 30
         width: parent.width
@@ -84,7 +101,8 @@ Dialog {
             color: fg
             font.bold: true
             text: {
-                   "Please enter password for file \"" + listView.model.SaveFile + "\":"
+                if (busy) "Unlocking file \"" + listView.model.SaveFile + "\"..."
+                else      "Please enter password for file \"" + listView.model.SaveFile + "\":"
             }
         }
 
@@ -107,6 +125,7 @@ Dialog {
                 activeFocusOnTab: true
                 selectByMouse: true
                 maximumLength: 32
+                readOnly: busy
                 horizontalAlignment: TextInput.AlignHCenter
                 verticalAlignment: TextInput.AlignVCenter
                 text: ""
@@ -117,13 +136,14 @@ Dialog {
                 //passwordMaskDelay: 300
 
                 onAccepted: {
+                    if (busy) return;
                     if (pwEntry.mode===1) {
-                        listView.model.load_data(pwText.text,pwEntry.filename);
+                        listView.model.load_data(pwText.text,pwEntry.filename);   // Dialog is closed on loadFinished
                     }
                     else {
                         listView.model.set_password(pwText.text);
+                        pwEntry.close();
                     }
-                    pwEntry.close();
                 }
             }
 
@@ -166,6 +186,27 @@ Dialog {
 
         }
 
+        // Progress of key derivation & decryption:
+        Rectangle {
+            id: progress
+            x: form.leftEdge
+            y: form.topEdge + 95
+            width: 220
+            height: 6
+            visible: busy
+            color: bg
+            border.color: fg
+            border.width: 1
+
+            Rectangle {
+                x: 1
+                y: 1
+                height: parent.height - 2
+                width: (parent.width - 2) * listView.model.PWprogress / 100
+                color: highlightGreen
+            }
+        }
+
     }
 
 
@@ -198,6 +239,10 @@ Dialog {
             }
 
              onClicked: {
+                 if (busy) {
+                     listView.model.cancelLoad();  // Stop unlocking, the user can enter another password
+                     return;
+                 }
                  if (mode===1) listView.model.removeAll();  // If user clicks Cancel while loading file, clear all references to the file to prevent overwriting it with empty data
                  pwEntry.close()
              }
@@ -226,14 +271,16 @@ Dialog {
                 text: "OK"
             }
 
+            enabled: !busy
+
             onClicked: {
                 if (pwEntry.mode===1) {
-                    listView.model.load_data(pwText.text,pwEntry.filename);
+                    listView.model.load_data(pwText.text,pwEntry.filename);   // Dialog is closed on loadFinished
                 }
                 else {
                     listView.model.set_password(pwText.text);
+                    pwEntry.close();
                 }
-                pwEntry.close();
             }
 
         }
@@ -135,11 +135,13 @@ Dialog {
                 DialogButtonBox.buttonRole: DialogButtonBox.AcceptRole
 
                 onClicked: {
-                    if (reallocateAll) {listDaily.model.reallocateAll(sourceID, dateCount, listView.model.settingWeightedReallocation);}
-                    else               {listDaily.model.reallocate(sourceID, dateCount, listView.model.settingWeightedReallocation);}
+                    // Reallocation & reset of the targets in one edit (one undo step, one update of the views):
+                    listDaily.model.applyEdits([
+                        { op: reallocateAll ? "reallocateAll" : "reallocate", ID: sourceID, day: dateCount, weighted: listView.model.settingWeightedReallocation },
+                        { op: "resetAllocate" }
+                    ]);
                     reallocating = false;
                     sourceID     = -1;
-                    listDaily.model.resetAllocate();
                     reallocate.close();
                 }
 
@@ -342,10 +342,12 @@ Window {
                     }
 
                     onClicked: {
-                        listDaily.model.reallocate(sourceID, dateCount, listView.model.settingWeightedReallocation);
+                        listDaily.model.applyEdits([
+                            { op: "reallocate", ID: sourceID, day: dateCount, weighted: listView.model.settingWeightedReallocation },
+                            { op: "resetAllocate" }
+                        ]);
                         reallocating = false;
                         sourceID     = -1;
-                        listDaily.model.resetAllocate();
                     }
 
                 }
@@ -0,0 +1,12 @@
+# Tests of the core library (task store), linked against the core sources.
+QT += testlib
+QT -= gui
+CONFIG += c++11 testcase console
+CONFIG -= app_bundle
+
+TARGET = tst_taskstore
+
+include(../../core/core.pri)
+
+SOURCES += \
+    tst_taskstore.cpp
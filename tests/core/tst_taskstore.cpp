@@ -0,0 +1,222 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <QtTest>
+#include "core/CTaskStore.h"
+#include "core/CLogger.h"
+
+// Undo & redo of the task store: the edits are undone & redone while the running task keeps counting time.
+
+class TestTaskStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void undoResetTodayKeepsCountedTime();
+    void undoResetTotalKeepsCountedTime();
+    void undoOnlyTouchesEditedDays();
+    void undoTitle();
+    void undoRemove();
+
+private:
+    void setUp(const QList<QMap<QDate, quint32>> &timelogs);
+    quint32 logged(int row, const QDate &date) const;
+
+    CLogger    *logger;
+    CTaskStore *store;
+    QDate       today;
+};
+
+
+void TestTaskStore::init()
+{
+    logger = new CLogger();   // Not opened - records are dropped
+    store  = new CTaskStore(*logger);
+    today  = store->today();
+}
+
+void TestTaskStore::cleanup()
+{
+    delete store;
+    delete logger;
+}
+
+
+void TestTaskStore::setUp(const QList<QMap<QDate, quint32>> &timelogs)
+{
+// One task per timelog ("Task 0", "Task 1", ...; IDs 100, 101, ...), the first one is running
+    QList<CTaskStore::Task> tasks;
+    QMap<QDate, quint32>::const_iterator it;
+    int i;
+
+    for (i=0; i<timelogs.count(); i++) {
+        CTaskStore::Task task;
+        task.title  = QString("Task %1").arg(i);
+        task.taskID = 100 + i;
+        for (it = timelogs.at(i).constBegin(); it != timelogs.at(i).constEnd(); ++it) {
+            task.timelog.insert(it.key(), CTaskStore::makeTime(it.value()));
+        }
+        tasks.append(task);
+    }
+    store->setTasks(tasks);
+    store->setActive(0, 1);
+}
+
+quint32 TestTaskStore::logged(int row, const QDate &date) const
+{
+    return store->timelog(row).value(date).elapsedSeconds;
+}
+
+
+void TestTaskStore::undoResetTodayKeepsCountedTime()
+{
+// Reset the running task, count an hour, undo & redo: the hour stays in both cases
+    QVector<int> rows;
+
+    setUp({ { { today.addDays(-1), 100 }, { today, 500 } } });
+
+    store->beginUndoStep("Reset today");
+    store->resetToday(0);
+    store->commitUndoStep();
+    QCOMPARE(store->seconds(0, CTaskStore::Today), 0u);
+
+    store->credit(100, today, 3600);
+    QCOMPARE(store->seconds(0, CTaskStore::Today), 3600u);
+
+    QVERIFY(store->undo(rows));
+    QCOMPARE(rows, QVector<int>({ 0 }));
+    QCOMPARE(store->seconds(0, CTaskStore::Today), 500u + 3600u);
+    QCOMPARE(store->seconds(0, CTaskStore::Total), 100u + 500u + 3600u);
+    QCOMPARE(store->totals().today.elapsedSeconds, 500u + 3600u);
+
+    store->credit(100, today, 60);
+    QVERIFY(store->redo(rows));
+    QCOMPARE(store->seconds(0, CTaskStore::Today), 3600u + 60u);
+    QCOMPARE(logged(0, today.addDays(-1)), 100u);
+}
+
+void TestTaskStore::undoResetTotalKeepsCountedTime()
+{
+// Reset all days of the running task, count on, undo: the old days come back, today keeps the time counted since
+    QVector<int> rows;
+
+    setUp({ { { today.addDays(-40), 7200 }, { today.addDays(-1), 100 }, { today, 500 } } });
+
+    store->beginUndoStep("Reset times");
+    store->resetTotal(0);
+    store->commitUndoStep();
+    QCOMPARE(store->timelog(0).count(), 1);
+
+    store->credit(100, today, 10);
+
+    QVERIFY(store->undo(rows));
+    QCOMPARE(store->timelog(0).count(), 3);
+    QCOMPARE(logged(0, today.addDays(-40)), 7200u);
+    QCOMPARE(logged(0, today.addDays(-1)), 100u);
+    QCOMPARE(logged(0, today), 510u);
+
+    QVERIFY(store->redo(rows));
+    QCOMPARE(store->timelog(0).count(), 1);
+    QCOMPARE(logged(0, today), 10u);
+    QCOMPARE(store->seconds(0, CTaskStore::Total), 10u);
+}
+
+void TestTaskStore::undoOnlyTouchesEditedDays()
+{
+// An edit of one day is undone on that day only - days edited without a step since stay as they are
+    QVector<int> rows;
+    QDate day = today.addDays(-3);
+
+    setUp({ { { day, 1000 }, { today.addDays(-2), 2000 }, { today, 0 } }, { { today, 0 } } });
+    store->setAllocate(1, 1);
+
+    store->beginUndoStep("Reallocate");
+    QVERIFY(store->reallocate(0, day, false));
+    store->commitUndoStep();
+    QCOMPARE(logged(0, day), 0u);
+    QCOMPARE(logged(1, day), 1000u);
+
+    store->credit(100, today, 30);
+    store->addTime(0, today.addDays(-2), 5);
+
+    QVERIFY(store->undo(rows));
+    QCOMPARE(rows.count(), 2);
+    QCOMPARE(logged(0, day), 1000u);
+    QVERIFY(!store->timelog(1).contains(day));
+    QCOMPARE(logged(0, today.addDays(-2)), 2005u);
+    QCOMPARE(logged(0, today), 30u);
+    QCOMPARE(store->allocate(1), (quint8) 1);
+
+    QVERIFY(store->redo(rows));
+    QCOMPARE(logged(0, day), 0u);
+    QCOMPARE(logged(1, day), 1000u);
+    QCOMPARE(logged(0, today), 30u);
+}
+
+void TestTaskStore::undoTitle()
+{
+    QVector<int> rows;
+
+    setUp({ { { today, 0 } } });
+
+    store->beginUndoStep("Edit task");
+    store->set(0, "Renamed", "Description");
+    store->commitUndoStep();
+    QCOMPARE(store->undoLabel(), QString("Edit task"));
+    QVERIFY(!store->undoMovesRows());
+
+    QVERIFY(store->undo(rows));
+    QCOMPARE(store->title(0), QString("Task 0"));
+    QCOMPARE(store->description(0), QString());
+    QCOMPARE(store->redoLabel(), QString("Edit task"));
+
+    QVERIFY(store->redo(rows));
+    QCOMPARE(store->title(0), QString("Renamed"));
+    QCOMPARE(store->description(0), QString("Description"));
+}
+
+void TestTaskStore::undoRemove()
+{
+// A task removed comes back to its row with its whole timelog, and goes again on redo
+    QVector<int> rows;
+
+    setUp({ { { today, 10 } }, { { today.addDays(-400), 99 }, { today, 20 } }, { { today, 30 } } });
+
+    store->beginUndoStep("Remove task");
+    store->remove(1);
+    store->commitUndoStep();
+    QCOMPARE(store->count(), 2);
+    QVERIFY(store->undoMovesRows());
+
+    QVERIFY(store->undo(rows));
+    QCOMPARE(store->count(), 3);
+    QCOMPARE(store->taskID(1), 101u);
+    QCOMPARE(store->title(1), QString("Task 1"));
+    QCOMPARE(logged(1, today.addDays(-400)), 99u);
+    QCOMPARE(store->seconds(1, CTaskStore::Total), 99u + 20u);
+
+    QVERIFY(store->redoMovesRows());
+    QVERIFY(store->redo(rows));
+    QCOMPARE(store->count(), 2);
+    QCOMPARE(store->row(101), -1);
+    QCOMPARE(store->taskID(1), 102u);
+}
+
+
+QTEST_GUILESS_MAIN(TestTaskStore)
+
+#include "tst_taskstore.moc"
@@ -0,0 +1,12 @@
+# Known-answer tests for the crypto code, plus throughput benchmarks (QBENCHMARK, run with "-tickcounter" for cycles).
+QT += testlib
+QT -= gui
+CONFIG += c++11 testcase console
+CONFIG -= app_bundle
+
+TARGET = tst_crypto
+
+include(../../crypto/crypto.pri)
+
+SOURCES += \
+    tst_crypto.cpp
@@ -0,0 +1,516 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <QtTest>
+#include "crypto/Crypto.h"
+#include "crypto/AES.h"
+#include "crypto/AESNI.h"
+#include "crypto/CBC.h"
+#include "crypto/CTR.h"
+#include "crypto/ChunkCipher.h"
+#include "crypto/SHA1.h"
+#include "crypto/SHA256.h"
+#include "crypto/SHAAccel.h"
+#include "crypto/pbkdf2.h"
+
+// Known answers from FIPS-197, SP 800-38A, FIPS 180 and RFC 2202/4231/6070 on whichever path the CPU selects
+// (AES-NI, SHA-NI, SSSE3 or portable); the multi-block and multithreaded paths are compared with the block-by-block
+// results. The benchmarks time the operations the save files depend on.
+
+static const char *AES256_KEY    = "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f";   // FIPS-197 C.3
+static const char *AES256_PLAIN  = "00112233445566778899aabbccddeeff";
+static const char *AES256_CIPHER = "8ea2b7ca516745bfeafc49904b496089";
+static const char *SP800_KEY     = "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4";   // SP 800-38A F.2.5 / F.5.5
+static const char *SP800_PLAIN   = "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+                                   "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+static const char *CBC_IV        = "000102030405060708090a0b0c0d0e0f";
+static const char *CBC_CIPHER    = "f58c4c04d6e5f1ba779eabfb5f7bfbd69cfc4e967edb808d679f777bc6702c7d"
+                                   "39f23369a9d9bacfa530e26304231461b2eb05e2c39be9fcda6c19078c6a9d1b";
+static const char *CTR_COUNTER   = "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+static const char *CTR_CIPHER    = "601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c5"
+                                   "2b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6";
+static const char *SHA_MSG448    = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+
+static QByteArray hex(const char *text)
+{
+    return QByteArray::fromHex(text);
+}
+
+static QByteArray bytes(const uint8_t *data, size_t len)
+{
+    return QByteArray((const char*) data, (int) len);
+}
+
+
+class TestCrypto : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    // Known-answer tests:
+    void aes256();
+    void aes256Blocks();
+    void cbc();
+    void cbcThreads();
+    void ctr();
+    void sha1_data();
+    void sha1();
+    void sha256_data();
+    void sha256();
+    void hmac();
+    void pbkdf2();
+    void chunkCipher();
+    void chunkCipherModified();
+    void chunkCipherPages();
+
+    // Benchmarks:
+    void benchmarkAES256Block();
+    void benchmarkAES256Blocks();
+    void benchmarkCBCEncrypt_data()     { cipherSizes(); }
+    void benchmarkCBCEncrypt();
+    void benchmarkCBCDecrypt_data()     { cipherSizes(); }
+    void benchmarkCBCDecrypt();
+    void benchmarkCTR_data()            { cipherSizes(); }
+    void benchmarkCTR();
+    void benchmarkSHA1_data()           { hashSizes(); }
+    void benchmarkSHA1();
+    void benchmarkSHA256_data()         { hashSizes(); }
+    void benchmarkSHA256();
+    void benchmarkHMAC_data()           { hashSizes(); }
+    void benchmarkHMAC();
+    void benchmarkChunkSeal();
+    void benchmarkChunkSealOpen();
+    void benchmarkChunkSealPages();
+    void benchmarkPBKDF2SHA1();
+    void benchmarkPBKDF2SHA256();
+
+private:
+    static void cipherSizes();
+    static void hashSizes();
+
+    QByteArray key;
+    QByteArray buffer;
+};
+
+
+void TestCrypto::initTestCase()
+{
+    qInfo("AES: %s, SHA: %s", aesni_available() ? "AES-NI" : "portable",
+          shani_available() ? "SHA-NI" : (ssse3_sha_available() ? "SSSE3" : "portable"));
+
+    key = hex(AES256_KEY);
+    buffer.fill(0x5A, 64 * 1024 * 1024);
+}
+
+
+void TestCrypto::aes256()
+{
+    QByteArray plain = hex(AES256_PLAIN);
+    uint8_t out[16];
+    AES256 aes;
+
+    aes.setKey((const uint8_t*) key.constData(), 32);
+    aes.encryptBlock(out, (const uint8_t*) plain.constData());
+    QCOMPARE(bytes(out, 16), hex(AES256_CIPHER));
+    aes.decryptBlock(out, out);
+    QCOMPARE(bytes(out, 16), plain);
+}
+
+void TestCrypto::aes256Blocks()
+{
+// Several blocks at a time (8 in parallel with AES-NI, plus a remainder) must match block by block
+    QByteArray blocks(16 * 37, 0), single(16 * 37, 0), multi(16 * 37, 0);
+    AES256 aes;
+    int i;
+
+    for (i = 0; i < blocks.size(); i++) blocks[i] = (char) (i * 7);
+    aes.setKey((const uint8_t*) key.constData(), 32);
+    for (i = 0; i < blocks.size(); i += 16)
+        aes.encryptBlock((uint8_t*) single.data() + i, (const uint8_t*) blocks.constData() + i);
+    aes.encryptBlocks((uint8_t*) multi.data(), (const uint8_t*) blocks.constData(), blocks.size() / 16);
+    QCOMPARE(multi, single);
+}
+
+void TestCrypto::cbc()
+{
+    QByteArray spKey = hex(SP800_KEY), iv = hex(CBC_IV), plain = hex(SP800_PLAIN);
+    QByteArray data(plain.size(), 0);
+    CBC<AES256> cbc;
+
+    cbc.setKey((const uint8_t*) spKey.constData(), 32);
+    cbc.setIV((const uint8_t*) iv.constData(), 16);
+    cbc.encrypt((uint8_t*) data.data(), (const uint8_t*) plain.constData(), data.size());
+    QCOMPARE(data, hex(CBC_CIPHER));
+    cbc.setIV((const uint8_t*) iv.constData(), 16);
+    cbc.decrypt((uint8_t*) data.data(), (const uint8_t*) data.constData(), data.size());
+    QCOMPARE(data, plain);
+}
+
+void TestCrypto::cbcThreads()
+{
+// Large buffers are decrypted on several threads - the result must not depend on it
+    QByteArray iv = hex(CBC_IV);
+    QByteArray big(1024 * 1024 + 48, 0), check;
+    CBC<AES256> cbc;
+    int i;
+
+    for (i = 0; i < big.size(); i++) big[i] = (char) (i * 13 + (i >> 11));
+    check = big;
+    cbc.setKey((const uint8_t*) key.constData(), 32);
+    cbc.setIV((const uint8_t*) iv.constData(), 16);
+    cbc.encrypt((uint8_t*) big.data(), (const uint8_t*) big.constData(), big.size());
+    QVERIFY(big != check);
+    cbc.setIV((const uint8_t*) iv.constData(), 16);
+    cbc.decrypt((uint8_t*) big.data(), (const uint8_t*) big.constData(), big.size());
+    QCOMPARE(big, check);
+}
+
+void TestCrypto::ctr()
+{
+    QByteArray spKey = hex(SP800_KEY), counter = hex(CTR_COUNTER), plain = hex(SP800_PLAIN);
+    QByteArray data(plain.size(), 0);
+    CTR<AES256> ctr;
+
+    ctr.setKey((const uint8_t*) spKey.constData(), 32);
+    ctr.setIV((const uint8_t*) counter.constData(), 16);
+    ctr.encrypt((uint8_t*) data.data(), (const uint8_t*) plain.constData(), data.size());
+    QCOMPARE(data, hex(CTR_CIPHER));
+}
+
+void TestCrypto::sha1_data()
+{
+    QTest::addColumn<QByteArray>("message");
+    QTest::addColumn<QByteArray>("digest");
+
+    QTest::newRow("abc")     << QByteArray("abc") << hex("a9993e364706816aba3e25717850c26c9cd0d89d");
+    QTest::newRow("448 bit") << QByteArray(SHA_MSG448) << hex("84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+}
+
+void TestCrypto::sha1()
+{
+    QFETCH(QByteArray, message);
+    QFETCH(QByteArray, digest);
+    uint8_t out[20];
+    SHA1 sha1;
+
+    sha1.update(message.constData(), message.size());
+    sha1.finalize(out, 20);
+    QCOMPARE(bytes(out, 20), digest);
+}
+
+void TestCrypto::sha256_data()
+{
+    QTest::addColumn<QByteArray>("message");
+    QTest::addColumn<QByteArray>("digest");
+
+    QTest::newRow("abc")     << QByteArray("abc") << hex("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    QTest::newRow("448 bit") << QByteArray(SHA_MSG448) << hex("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+}
+
+void TestCrypto::sha256()
+{
+    QFETCH(QByteArray, message);
+    QFETCH(QByteArray, digest);
+    uint8_t out[32];
+    SHA256 sha256;
+
+    sha256.update(message.constData(), message.size());
+    sha256.finalize(out, 32);
+    QCOMPARE(bytes(out, 32), digest);
+}
+
+void TestCrypto::hmac()
+{
+// RFC 2202 / RFC 4231, test case 2
+    uint8_t out[32];
+    SHA1 sha1;
+    SHA256 sha256;
+
+    sha1.resetHMAC("Jefe", 4);
+    sha1.update("what do ya want for nothing?", 28);
+    sha1.finalizeHMAC("Jefe", 4, out, 20);
+    QCOMPARE(bytes(out, 20), hex("effcdf6ae5eb2fa2d27416d5f184df9c259a7c79"));
+
+    sha256.resetHMAC("Jefe", 4);
+    sha256.update("what do ya want for nothing?", 28);
+    sha256.finalizeHMAC("Jefe", 4, out, 32);
+    QCOMPARE(bytes(out, 32), hex("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"));
+}
+
+void TestCrypto::pbkdf2()
+{
+// RFC 6070 (HMAC-SHA1) and the same parameters with HMAC-SHA256
+    uint8_t out[32];
+
+    pkcs5_pbkdf2((const uint8_t*) "password", 8, (const uint8_t*) "salt", 4, out, 20, 2);
+    QCOMPARE(bytes(out, 20), hex("ea6c014dc72d6f8ccd1ed92ace1d41f0d8de8957"));
+    pkcs5_pbkdf2_sha256((const uint8_t*) "password", 8, (const uint8_t*) "salt", 4, out, 32, 2);
+    QCOMPARE(bytes(out, 32), hex("ae4d0c95af6b46d32d0adff928f06dd02a303f8ef3c251dfd6e2d85a95474c43"));
+}
+
+void TestCrypto::chunkCipher()
+{
+// No published vectors - check the round trip
+    QByteArray plain(3 * CHUNK_SIZE + 100, 0), data;
+    uint8_t nonce[CHUNK_NONCE_SIZE] = { 0 };
+    ChunkCipher chunks;
+    int i;
+
+    for (i = 0; i < plain.size(); i++) plain[i] = (char) (i * 3);
+    chunks.setKey((const uint8_t*) key.constData(), 32);
+    chunks.setNonce(nonce);
+    chunks.setHeader((const uint8_t*) "header", 6);
+
+    data = plain;
+    data.resize((int) ChunkCipher::sealedSize(plain.size()));
+    chunks.seal((uint8_t*) data.data(), plain.size());
+    QVERIFY(chunks.open((uint8_t*) data.data(), data.size(), 0, ChunkCipher::chunkCount(plain.size())));
+    ChunkCipher::compact((uint8_t*) data.data(), data.size());
+    QCOMPARE(data.left(plain.size()), plain);
+}
+
+void TestCrypto::chunkCipherModified()
+{
+// Any modification must be detected
+    QByteArray data(3 * CHUNK_SIZE + 100, 0);
+    uint8_t nonce[CHUNK_NONCE_SIZE] = { 0 };
+    ChunkCipher chunks;
+    size_t plainSize = data.size();
+
+    chunks.setKey((const uint8_t*) key.constData(), 32);
+    chunks.setNonce(nonce);
+    chunks.setHeader((const uint8_t*) "header", 6);
+
+    data.resize((int) ChunkCipher::sealedSize(plainSize));
+    chunks.seal((uint8_t*) data.data(), plainSize);
+    data[CHUNK_SIZE + 5] = (char) (data[CHUNK_SIZE + 5] ^ 1);
+    QVERIFY(!chunks.open((uint8_t*) data.data(), data.size(), 0, ChunkCipher::chunkCount(plainSize)));
+}
+
+void TestCrypto::chunkCipherPages()
+{
+    uint8_t nonce[CHUNK_NONCE_SIZE] = { 0 };
+    uint8_t page[CHUNK_PAGE_STORED] = { 0 };
+    ChunkCipher chunks;
+
+    chunks.setKey((const uint8_t*) key.constData(), 32);
+    chunks.setNonce(nonce);
+    chunks.setHeader((const uint8_t*) "header", 6);
+
+    memset(page + CHUNK_PAGE_NONCE, 0x5A, CHUNK_PAGE_SIZE);
+    chunks.sealPage(7, page);
+    QVERIFY(!chunks.openPage(8, page));   // Page moved to another position
+    QVERIFY(chunks.openPage(7, page));
+    QCOMPARE(page[CHUNK_PAGE_NONCE], (uint8_t) 0x5A);
+    QCOMPARE(page[CHUNK_PAGE_NONCE + CHUNK_PAGE_SIZE - 1], (uint8_t) 0x5A);
+}
+
+
+void TestCrypto::benchmarkAES256Block()
+{
+    uint8_t *data = (uint8_t*) buffer.data();
+    AES256 aes;
+
+    aes.setKey((const uint8_t*) key.constData(), 32);
+    QBENCHMARK {
+        aes.encryptBlock(data, data);
+    }
+}
+
+void TestCrypto::benchmarkAES256Blocks()
+{
+    uint8_t *data = (uint8_t*) buffer.data();
+    AES256 aes;
+
+    aes.setKey((const uint8_t*) key.constData(), 32);
+    QBENCHMARK {
+        aes.encryptBlocks(data, data, 4096);   // 64 KB
+    }
+}
+
+void TestCrypto::cipherSizes()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("1 KB")  << 1024;
+    QTest::newRow("64 KB") << 64 * 1024;
+    QTest::newRow("1 MB")  << 1024 * 1024;
+    QTest::newRow("64 MB") << 64 * 1024 * 1024;
+}
+
+void TestCrypto::benchmarkCBCEncrypt()
+{
+    QFETCH(int, size);
+    uint8_t *data = (uint8_t*) buffer.data();
+    uint8_t iv[16] = { 0 };
+    CBC<AES256> cbc;
+
+    cbc.setKey((const uint8_t*) key.constData(), 32);
+    cbc.setIV(iv, 16);
+    QBENCHMARK {
+        cbc.encrypt(data, data, size);
+    }
+}
+
+void TestCrypto::benchmarkCBCDecrypt()
+{
+    QFETCH(int, size);
+    uint8_t *data = (uint8_t*) buffer.data();
+    uint8_t iv[16] = { 0 };
+    CBC<AES256> cbc;
+
+    cbc.setKey((const uint8_t*) key.constData(), 32);
+    cbc.setIV(iv, 16);
+    QBENCHMARK {
+        cbc.decrypt(data, data, size);
+    }
+}
+
+void TestCrypto::benchmarkCTR()
+{
+    QFETCH(int, size);
+    uint8_t *data = (uint8_t*) buffer.data();
+    uint8_t iv[16] = { 0 };
+    CTR<AES256> ctr;
+
+    ctr.setKey((const uint8_t*) key.constData(), 32);
+    ctr.setIV(iv, 16);
+    QBENCHMARK {
+        ctr.encrypt(data, data, size);
+    }
+}
+
+void TestCrypto::hashSizes()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("1 KB")  << 1024;
+    QTest::newRow("64 KB") << 64 * 1024;
+    QTest::newRow("1 MB")  << 1024 * 1024;
+}
+
+void TestCrypto::benchmarkSHA1()
+{
+    QFETCH(int, size);
+    uint8_t out[20];
+    SHA1 sha1;
+
+    QBENCHMARK {
+        sha1.reset();
+        sha1.update(buffer.constData(), size);
+        sha1.finalize(out, 20);
+    }
+}
+
+void TestCrypto::benchmarkSHA256()
+{
+    QFETCH(int, size);
+    uint8_t out[32];
+    SHA256 sha256;
+
+    QBENCHMARK {
+        sha256.reset();
+        sha256.update(buffer.constData(), size);
+        sha256.finalize(out, 32);
+    }
+}
+
+void TestCrypto::benchmarkHMAC()
+{
+    QFETCH(int, size);
+    uint8_t out[32];
+    SHA256 sha256;
+
+    QBENCHMARK {
+        sha256.resetHMAC(key.constData(), 32);
+        sha256.update(buffer.constData(), size);
+        sha256.finalizeHMAC(key.constData(), 32, out, 32);
+    }
+}
+
+void TestCrypto::benchmarkChunkSeal()
+{
+    const size_t len = 1024 * 1024;
+    uint8_t *data = (uint8_t*) buffer.data();
+    uint8_t nonce[CHUNK_NONCE_SIZE] = { 0 };
+    ChunkCipher chunks;
+
+    chunks.setKey((const uint8_t*) key.constData(), 32);
+    chunks.setNonce(nonce);
+    chunks.setHeader((const uint8_t*) "header", 6);
+    QBENCHMARK {
+        chunks.seal(data, len);
+    }
+}
+
+void TestCrypto::benchmarkChunkSealOpen()
+{
+    const size_t len = 1024 * 1024;
+    uint8_t *data = (uint8_t*) buffer.data();
+    uint8_t nonce[CHUNK_NONCE_SIZE] = { 0 };
+    ChunkCipher chunks;
+
+    chunks.setKey((const uint8_t*) key.constData(), 32);
+    chunks.setNonce(nonce);
+    chunks.setHeader((const uint8_t*) "header", 6);
+    QBENCHMARK {
+        chunks.seal(data, len);
+        chunks.open(data, ChunkCipher::sealedSize(len), 0, ChunkCipher::chunkCount(len));
+        ChunkCipher::compact(data, ChunkCipher::sealedSize(len));
+    }
+}
+
+void TestCrypto::benchmarkChunkSealPages()
+{
+    uint8_t *data = (uint8_t*) buffer.data();
+    uint8_t nonce[CHUNK_NONCE_SIZE] = { 0 };
+    ChunkCipher chunks;
+
+    chunks.setKey((const uint8_t*) key.constData(), 32);
+    chunks.setNonce(nonce);
+    chunks.setHeader((const uint8_t*) "header", 6);
+    QBENCHMARK {
+        chunks.sealPages(data, 0, 1024);
+    }
+}
+
+void TestCrypto::benchmarkPBKDF2SHA1()
+{
+// Key derivation with the parameters of the v100 save files
+    uint8_t salt[16] = { 0 };
+    uint8_t out[32];
+
+    QBENCHMARK {
+        pkcs5_pbkdf2((const uint8_t*) "password", 8, salt, 16, out, 32, 4096);
+    }
+}
+
+void TestCrypto::benchmarkPBKDF2SHA256()
+{
+// Key derivation with the parameters of the chunked save files
+    uint8_t salt[16] = { 0 };
+    uint8_t out[32];
+
+    QBENCHMARK {
+        pkcs5_pbkdf2_sha256((const uint8_t*) "password", 8, salt, 16, out, 32, 10000);
+    }
+}
+
+
+QTEST_APPLESS_MAIN(TestCrypto)
+
+#include "tst_crypto.moc"
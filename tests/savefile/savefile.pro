@@ -0,0 +1,12 @@
+# Tests of the encrypted save files (incremental saves & the journal), linked against the core sources.
+QT += testlib
+QT -= gui
+CONFIG += c++11 testcase console
+CONFIG -= app_bundle
+
+TARGET = tst_savefile
+
+include(../../core/core.pri)
+
+SOURCES += \
+    tst_savefile.cpp
@@ -0,0 +1,285 @@
+/*
+Copyright (C) 2020 by Sebastian Kauertz.
+
+This file is part of Timekeeper, a Qt-based time tracking app.
+
+Timekeeper is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+Timekeeper is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program.
+If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <QtTest>
+#include <QTemporaryDir>
+#include "core/CSaveFile.h"
+
+// Encrypted (version 103) save files: incremental saves, and saves interrupted while the journal was applied.
+// The journal of an interrupted save is rebuilt from the file before & after the save, the way writePagedIncremental() writes it.
+
+class TestSaveFile : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void incrementalSave();
+    void saveAfterLoad();
+    void longTexts();
+    void interruptedSave_data();
+    void interruptedSave();
+    void obsoleteJournal();
+
+private:
+    struct sEntry {
+        quint64    offset;
+        QByteArray data;
+    };
+    void save(const QString &title);
+    int  load(QString &title);
+    static QByteArray readAll(const QString &name);
+    static void writeAll(const QString &name, const QByteArray &data);
+    static QVector<sEntry> entries(const QByteArray &before, const QByteArray &after);
+    static QByteArray journal(const QByteArray &before, const QByteArray &after, const QVector<sEntry> &entries);
+
+    QTemporaryDir *dir;
+    QString        file;
+    CLogger       *logger;
+    CTaskStore    *store;
+    CSaveFile     *saveFile;
+};
+
+
+void TestSaveFile::init()
+{
+// 50 tasks (a slot of one page each), saved to a new encrypted file
+    int i;
+
+    dir      = new QTemporaryDir();
+    file     = dir->filePath("tasks.dat");
+    logger   = new CLogger();   // Not opened - records are dropped
+    store    = new CTaskStore(*logger);
+    saveFile = new CSaveFile(*store, *logger);
+
+    for (i=0; i<50; i++) {
+        store->append(QString("Task %1").arg(i), "");
+    }
+    saveFile->set_password("secret");
+    QCOMPARE(saveFile->save_data(file), 0);
+}
+
+void TestSaveFile::cleanup()
+{
+    delete saveFile;
+    delete store;
+    delete logger;
+    delete dir;
+}
+
+
+void TestSaveFile::save(const QString &title)
+{
+// Rename the first & the last task
+    store->set(0, title, "Description");
+    store->set(49, title, "Description");
+    QCOMPARE(saveFile->save_data(file), 0);
+}
+
+int TestSaveFile::load(QString &title)
+{
+// Load the file into a store of its own, as on the next start - returns the status reported by loaded()
+    CTaskStore loaded(*logger);
+    CSaveFile  loader(loaded, *logger);
+    QSignalSpy spy(&loader, &CSaveFile::loaded);
+
+    loader.load_data("secret", file);
+    if (spy.isEmpty() && !spy.wait(60000)) return -1;
+    if (loaded.count() > 0) title = loaded.title(0);
+    return spy.first().first().toInt();
+}
+
+QByteArray TestSaveFile::readAll(const QString &name)
+{
+    QFile in(name);
+
+    if (!in.open(QIODevice::ReadOnly)) return QByteArray();
+    return in.readAll();
+}
+
+void TestSaveFile::writeAll(const QString &name, const QByteArray &data)
+{
+    QFile out(name);
+
+    QVERIFY(out.open(QIODevice::WriteOnly));
+    QCOMPARE(out.write(data), (qint64) data.size());
+}
+
+QVector<TestSaveFile::sEntry> TestSaveFile::entries(const QByteArray &before, const QByteArray &after)
+{
+// The journal entries of a save: the new file information first, then every page that differs
+    QVector<sEntry> list;
+    int offset;
+
+    list.append({ 54, after.mid(54, PAGED_META_SIZE) });
+    for (offset = PAGED_DATA_START; offset < after.size(); offset += CHUNK_PAGE_STORED) {
+        if (before.mid(offset, CHUNK_PAGE_STORED) != after.mid(offset, CHUNK_PAGE_STORED)) {
+            list.append({ (quint64) offset, after.mid(offset, CHUNK_PAGE_STORED) });
+        }
+    }
+    return list;
+}
+
+QByteArray TestSaveFile::journal(const QByteArray &before, const QByteArray &after, const QVector<sEntry> &entries)
+{
+// Magic no., no. of entries, file information before & after, entries (offset, length, data), SHA256 of all this
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    SHA256  hash;
+    uint8_t checksum[32];
+    int i;
+
+    out.setVersion(QDataStream::Qt_5_0);
+    out << (quint32) 0x051076C0 << (quint32) entries.count();
+    out.writeRawData(before.constData() + 54, PAGED_META_SIZE);
+    out.writeRawData(after.constData() + 54, PAGED_META_SIZE);
+    for (i=0; i<entries.count(); i++) {
+        out << entries.at(i).offset << (quint32) entries.at(i).data.size();
+        out.writeRawData(entries.at(i).data.constData(), entries.at(i).data.size());
+    }
+    hash.update(data.constData(), data.size());
+    hash.finalize(checksum, 32);
+    data.append((const char*) checksum, 32);
+
+    return data;
+}
+
+
+void TestSaveFile::incrementalSave()
+{
+// Renaming two tasks rewrites the file information and the one page of each slot, nothing else
+    QByteArray before, after;
+    QString title;
+
+    save("Before");
+    before = readAll(file);
+    save("After");
+    after = readAll(file);
+
+    QCOMPARE(after.size(), before.size());
+    QCOMPARE(entries(before, after).count(), 3);
+    QVERIFY(!QFile::exists(file + ".journal"));
+    QCOMPARE(load(title), 0);
+    QCOMPARE(title, QString("After"));
+}
+
+void TestSaveFile::saveAfterLoad()
+{
+// The page layout read on loading is good for saving incrementally: one task renamed, one page written
+    CTaskStore loaded(*logger);
+    CSaveFile  loader(loaded, *logger);
+    QSignalSpy spy(&loader, &CSaveFile::loaded);
+    QByteArray before;
+
+    loader.load_data("secret", file);
+    QVERIFY(!spy.isEmpty() || spy.wait(60000));
+    QCOMPARE(spy.first().first().toInt(), 0);
+    QCOMPARE(loaded.count(), 50);
+
+    before = readAll(file);
+    loaded.set(7, "Renamed", "");
+    QCOMPARE(loader.save_data(file), 0);
+    QCOMPARE(entries(before, readAll(file)).count(), 2);
+}
+
+void TestSaveFile::longTexts()
+{
+// Title & description are cut to 32 & 128 Bytes of UTF-8 - nothing is written past the record
+    CTaskStore loaded(*logger);
+    CSaveFile  loader(loaded, *logger);
+    QSignalSpy spy(&loader, &CSaveFile::loaded);
+    QString umlaut = QString::fromUtf8("\xc3\xa4");   // 2 Bytes
+
+    store->set(0, umlaut.repeated(40), "");
+    store->set(1, "Task 1", QString("x").repeated(129));
+    store->set(49, "Task 49", umlaut.repeated(100000));   // The last record, far beyond the memory of all records
+    QCOMPARE(saveFile->save_data(file), 0);
+
+    loader.load_data("secret", file);
+    QVERIFY(!spy.isEmpty() || spy.wait(60000));
+    QCOMPARE(spy.first().first().toInt(), 0);
+    QCOMPARE(loaded.count(), 50);
+    QCOMPARE(loaded.title(0), umlaut.repeated(16));
+    QCOMPARE(loaded.title(1), QString("Task 1"));
+    QCOMPARE(loaded.description(1), QString("x").repeated(128));
+    QCOMPARE(loaded.title(49), QString("Task 49"));
+    QCOMPARE(loaded.description(49), umlaut.repeated(64));
+}
+
+void TestSaveFile::interruptedSave_data()
+{
+    QTest::addColumn<int>("written");   // Entries of the journal in the file when the save was interrupted (-1: all)
+
+    QTest::newRow("nothing written")           << 0;
+    QTest::newRow("file information")          << 1;
+    QTest::newRow("file information & a page") << 2;
+    QTest::newRow("journal not removed")       << -1;
+}
+
+void TestSaveFile::interruptedSave()
+{
+// The next load completes the save, no matter how far applying the journal got
+    QFETCH(int, written);
+    QByteArray before, after, crashed;
+    QVector<sEntry> list;
+    QString title;
+    int i;
+
+    save("Before");
+    before = readAll(file);
+    save("After");
+    after = readAll(file);
+    list = entries(before, after);
+    if (written < 0) written = list.count();
+    QVERIFY(written <= list.count());
+
+    crashed = before;
+    for (i=0; i<written; i++) {
+        crashed.replace(list.at(i).offset, list.at(i).data.size(), list.at(i).data);
+    }
+    writeAll(file, crashed);
+    writeAll(file + ".journal", journal(before, after, list));
+
+    QCOMPARE(load(title), 0);
+    QCOMPARE(title, QString("After"));
+    QVERIFY(!QFile::exists(file + ".journal"));
+    QVERIFY(readAll(file) == after);
+}
+
+void TestSaveFile::obsoleteJournal()
+{
+// A journal left over from an earlier save is discarded - the file stays as it is
+    QByteArray before, after, latest;
+    QString title;
+
+    save("Before");
+    before = readAll(file);
+    save("After");
+    after = readAll(file);
+    save("Latest");
+    latest = readAll(file);
+    writeAll(file + ".journal", journal(before, after, entries(before, after)));
+
+    QCOMPARE(load(title), 0);
+    QCOMPARE(title, QString("Latest"));
+    QVERIFY(!QFile::exists(file + ".journal"));
+    QVERIFY(readAll(file) == latest);
+}
+
+
+QTEST_GUILESS_MAIN(TestSaveFile)
+
+#include "tst_savefile.moc"
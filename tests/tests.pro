@@ -0,0 +1,7 @@
+# Unit tests & benchmarks (QtTest). Build with "qmake tests/tests.pro && make", run with "make check".
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    core \
+    crypto \
+    savefile